@@ -0,0 +1,625 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * Offline analyzer for heap snapshots written by `bt_heap_snapshot`.
+ * Builds the reference graph, computes the dominator tree (Cooper, Harvey & Kennedy's iterative algorithm)
+ * and reports retained sizes by object type, by module, by root, and for the largest individual retainers.
+ */
+
+#define UNDEFINED 0xFFFFFFFFu
+#define MAX_TYPES 32
+#define MAX_ROOT_NAMES 64
+
+typedef struct Node {
+	uint64_t id;
+	uint64_t size;
+	uint64_t retained;
+	char* label;
+	uint32_t type;
+	uint32_t root_name;
+	uint32_t first_ref, ref_count;
+} Node;
+
+typedef struct Heap {
+	Node* nodes;
+	uint32_t node_count, node_cap;
+
+	uint64_t* ref_ids;
+	uint32_t* refs;
+	uint32_t ref_count, ref_cap;
+
+	uint64_t* root_ids;
+	uint32_t* root_names;
+	uint32_t root_count, root_cap;
+
+	char* types[MAX_TYPES];
+	uint32_t type_count;
+
+	char* root_name_table[MAX_ROOT_NAMES];
+	uint32_t root_name_count;
+
+	uint32_t* lookup;
+	uint32_t lookup_cap;
+} Heap;
+
+typedef struct Parser {
+	const char* cursor;
+	const char* end;
+	const char* error;
+} Parser;
+
+static void* grow(void* ptr, uint32_t* cap, uint32_t count, size_t element_size)
+{
+	if (count < *cap) return ptr;
+	*cap = *cap ? *cap * 2 : 256;
+	ptr = realloc(ptr, *cap * element_size);
+	if (!ptr) {
+		printf("ERROR: Out of memory!\n");
+		exit(1);
+	}
+	return ptr;
+}
+
+static void skip_whitespace(Parser* p)
+{
+	while (p->cursor < p->end && (*p->cursor == ' ' || *p->cursor == '\n' || *p->cursor == '\r' || *p->cursor == '\t')) p->cursor++;
+}
+
+static int expect(Parser* p, char c)
+{
+	skip_whitespace(p);
+	if (p->cursor < p->end && *p->cursor == c) {
+		p->cursor++;
+		return 1;
+	}
+
+	if (!p->error) p->error = "Unexpected character";
+	return 0;
+}
+
+static int peek(Parser* p, char c)
+{
+	skip_whitespace(p);
+	return p->cursor < p->end && *p->cursor == c;
+}
+
+static uint64_t parse_number(Parser* p)
+{
+	skip_whitespace(p);
+	uint64_t result = 0;
+	if (p->cursor >= p->end || *p->cursor < '0' || *p->cursor > '9') {
+		if (!p->error) p->error = "Expected number";
+		return 0;
+	}
+
+	while (p->cursor < p->end && *p->cursor >= '0' && *p->cursor <= '9') {
+		result = result * 10 + (uint64_t)(*p->cursor++ - '0');
+	}
+
+	return result;
+}
+
+/** Parses a json string into a freshly allocated buffer. Non-ascii escapes are replaced with '?' */
+static char* parse_string(Parser* p)
+{
+	if (!expect(p, '"')) return NULL;
+
+	const char* start = p->cursor;
+	while (p->cursor < p->end && *p->cursor != '"') {
+		if (*p->cursor == '\\') p->cursor++;
+		p->cursor++;
+	}
+
+	if (p->cursor >= p->end) {
+		if (!p->error) p->error = "Unterminated string";
+		return NULL;
+	}
+
+	char* result = malloc(p->cursor - start + 1);
+	char* out = result;
+	for (const char* in = start; in < p->cursor; ++in) {
+		if (*in != '\\') {
+			*out++ = *in;
+			continue;
+		}
+
+		in++;
+		switch (*in) {
+		case 'n': *out++ = '\n'; break;
+		case 't': *out++ = '\t'; break;
+		case 'r': *out++ = '\r'; break;
+		case 'u': {
+			unsigned int code = 0;
+			if (in + 4 < p->cursor && sscanf(in + 1, "%4x", &code) == 1) in += 4;
+			*out++ = code >= 0x20 && code < 0x7f ? (char)code : '?';
+		} break;
+		default: *out++ = *in; break;
+		}
+	}
+	*out = 0;
+
+	p->cursor++;
+	return result;
+}
+
+static void skip_value(Parser* p)
+{
+	skip_whitespace(p);
+	if (p->cursor >= p->end) return;
+
+	if (*p->cursor == '"') {
+		free(parse_string(p));
+		return;
+	}
+
+	uint32_t depth = 0;
+	do {
+		char c = *p->cursor;
+		if (c == '"') {
+			free(parse_string(p));
+			continue;
+		}
+
+		if (c == '[' || c == '{') depth++;
+		else if (c == ']' || c == '}') depth--;
+		else if (depth == 0 && (c == ',')) break;
+		p->cursor++;
+	} while (p->cursor < p->end && depth > 0);
+}
+
+static uint32_t intern(char** table, uint32_t* count, uint32_t max, char* name)
+{
+	for (uint32_t i = 0; i < *count; ++i) {
+		if (strcmp(table[i], name) == 0) {
+			free(name);
+			return i;
+		}
+	}
+
+	if (*count == max) {
+		free(name);
+		return max - 1;
+	}
+
+	table[*count] = name;
+	return (*count)++;
+}
+
+static uint32_t hash_id(uint64_t id, uint32_t cap)
+{
+	id ^= id >> 33;
+	id *= 0xff51afd7ed558ccdull;
+	id ^= id >> 33;
+	return (uint32_t)id & (cap - 1);
+}
+
+static void build_lookup(Heap* heap)
+{
+	heap->lookup_cap = 16;
+	while (heap->lookup_cap < heap->node_count * 2) heap->lookup_cap *= 2;
+
+	heap->lookup = malloc(heap->lookup_cap * sizeof(uint32_t));
+	memset(heap->lookup, 0xFF, heap->lookup_cap * sizeof(uint32_t));
+
+	for (uint32_t i = 1; i < heap->node_count; ++i) {
+		uint32_t slot = hash_id(heap->nodes[i].id, heap->lookup_cap);
+		while (heap->lookup[slot] != UNDEFINED) slot = (slot + 1) & (heap->lookup_cap - 1);
+		heap->lookup[slot] = i;
+	}
+}
+
+static uint32_t find_node(Heap* heap, uint64_t id)
+{
+	uint32_t slot = hash_id(id, heap->lookup_cap);
+	while (heap->lookup[slot] != UNDEFINED) {
+		if (heap->nodes[heap->lookup[slot]].id == id) return heap->lookup[slot];
+		slot = (slot + 1) & (heap->lookup_cap - 1);
+	}
+
+	return UNDEFINED;
+}
+
+static void parse_roots(Parser* p, Heap* heap)
+{
+	if (!expect(p, '[')) return;
+
+	while (!p->error && !peek(p, ']')) {
+		expect(p, '[');
+		uint64_t id = parse_number(p);
+		expect(p, ',');
+		char* name = parse_string(p);
+		expect(p, ']');
+		if (p->error) return;
+
+		heap->root_ids = grow(heap->root_ids, &heap->root_cap, heap->root_count, sizeof(uint64_t));
+		heap->root_names = realloc(heap->root_names, heap->root_cap * sizeof(uint32_t));
+		heap->root_ids[heap->root_count] = id;
+		heap->root_names[heap->root_count] = intern(heap->root_name_table, &heap->root_name_count, MAX_ROOT_NAMES, name);
+		heap->root_count++;
+
+		if (!peek(p, ',')) break;
+		p->cursor++;
+	}
+
+	expect(p, ']');
+}
+
+static void parse_nodes(Parser* p, Heap* heap)
+{
+	if (!expect(p, '[')) return;
+
+	while (!p->error && !peek(p, ']')) {
+		Node node;
+		memset(&node, 0, sizeof(Node));
+
+		expect(p, '[');
+		node.id = parse_number(p);
+		expect(p, ',');
+		char* type = parse_string(p);
+		expect(p, ',');
+		node.size = parse_number(p);
+		expect(p, ',');
+		node.label = parse_string(p);
+		expect(p, ',');
+		if (p->error) return;
+
+		node.type = intern(heap->types, &heap->type_count, MAX_TYPES, type);
+		node.root_name = UNDEFINED;
+		node.first_ref = heap->ref_count;
+
+		expect(p, '[');
+		while (!p->error && !peek(p, ']')) {
+			heap->ref_ids = grow(heap->ref_ids, &heap->ref_cap, heap->ref_count, sizeof(uint64_t));
+			heap->ref_ids[heap->ref_count++] = parse_number(p);
+			if (!peek(p, ',')) break;
+			p->cursor++;
+		}
+		expect(p, ']');
+		expect(p, ']');
+
+		node.ref_count = heap->ref_count - node.first_ref;
+
+		heap->nodes = grow(heap->nodes, &heap->node_cap, heap->node_count, sizeof(Node));
+		heap->nodes[heap->node_count++] = node;
+
+		if (!peek(p, ',')) break;
+		p->cursor++;
+	}
+
+	expect(p, ']');
+}
+
+static int parse_snapshot(Parser* p, Heap* heap)
+{
+	if (!expect(p, '{')) return 0;
+
+	while (!p->error && !peek(p, '}')) {
+		char* key = parse_string(p);
+		expect(p, ':');
+		if (p->error) {
+			free(key);
+			return 0;
+		}
+
+		if (strcmp(key, "format") == 0) {
+			char* format = parse_string(p);
+			if (format && strcmp(format, "bolt-heap") != 0) p->error = "Not a bolt heap snapshot";
+			free(format);
+		}
+		else if (strcmp(key, "version") == 0) {
+			if (parse_number(p) != 1) p->error = "Unsupported snapshot version";
+		}
+		else if (strcmp(key, "roots") == 0) parse_roots(p, heap);
+		else if (strcmp(key, "nodes") == 0) parse_nodes(p, heap);
+		else skip_value(p);
+
+		free(key);
+		if (!peek(p, ',')) break;
+		p->cursor++;
+	}
+
+	expect(p, '}');
+	return p->error == NULL;
+}
+
+/** Resolves reference ids into node indices, and attaches the roots to a synthetic node 0 */
+static void link_graph(Heap* heap)
+{
+	build_lookup(heap);
+
+	heap->refs = malloc((heap->ref_count + heap->root_count + 1) * sizeof(uint32_t));
+	for (uint32_t i = 0; i < heap->ref_count; ++i) {
+		heap->refs[i] = find_node(heap, heap->ref_ids[i]);
+	}
+
+	Node* root = heap->nodes;
+	root->first_ref = heap->ref_count;
+	for (uint32_t i = 0; i < heap->root_count; ++i) {
+		uint32_t target = find_node(heap, heap->root_ids[i]);
+		heap->refs[root->first_ref + root->ref_count++] = target;
+		if (target != UNDEFINED && heap->nodes[target].root_name == UNDEFINED) {
+			heap->nodes[target].root_name = heap->root_names[i];
+		}
+	}
+}
+
+static uint32_t intersect(uint32_t* idom, uint32_t* post, uint32_t a, uint32_t b)
+{
+	while (a != b) {
+		while (post[a] < post[b]) a = idom[a];
+		while (post[b] < post[a]) b = idom[b];
+	}
+
+	return a;
+}
+
+/** Computes `idom` for every node reachable from node 0, returning the nodes in postorder */
+static uint32_t* compute_dominators(Heap* heap, uint32_t* idom, uint32_t* post, uint32_t* reachable)
+{
+	uint32_t n = heap->node_count;
+	uint32_t* order = malloc(n * sizeof(uint32_t));
+	uint32_t* stack = malloc(n * sizeof(uint32_t));
+	uint32_t* edge = malloc(n * sizeof(uint32_t));
+	uint32_t count = 0, top = 0;
+
+	for (uint32_t i = 0; i < n; ++i) {
+		idom[i] = UNDEFINED;
+		post[i] = UNDEFINED;
+		edge[i] = 0;
+	}
+
+	// Iterative depth-first search for the postorder, using UNDEFINED - 1 to flag nodes currently on the stack
+	stack[top++] = 0;
+	post[0] = UNDEFINED - 1;
+	while (top) {
+		uint32_t node = stack[top - 1];
+		Node* as_node = heap->nodes + node;
+		if (edge[node] < as_node->ref_count) {
+			uint32_t next = heap->refs[as_node->first_ref + edge[node]++];
+			if (next != UNDEFINED && post[next] == UNDEFINED) {
+				post[next] = UNDEFINED - 1;
+				stack[top++] = next;
+			}
+		}
+		else {
+			post[node] = count;
+			order[count++] = node;
+			top--;
+		}
+	}
+
+	// Predecessor lists in compressed form
+	uint32_t* pred_start = calloc(n + 1, sizeof(uint32_t));
+	for (uint32_t i = 0; i < n; ++i) {
+		Node* node = heap->nodes + i;
+		if (post[i] == UNDEFINED) continue;
+		for (uint32_t r = 0; r < node->ref_count; ++r) {
+			uint32_t target = heap->refs[node->first_ref + r];
+			if (target != UNDEFINED) pred_start[target + 1]++;
+		}
+	}
+	for (uint32_t i = 0; i < n; ++i) pred_start[i + 1] += pred_start[i];
+
+	uint32_t* preds = malloc((pred_start[n] + 1) * sizeof(uint32_t));
+	uint32_t* fill = calloc(n, sizeof(uint32_t));
+	for (uint32_t i = 0; i < n; ++i) {
+		Node* node = heap->nodes + i;
+		if (post[i] == UNDEFINED) continue;
+		for (uint32_t r = 0; r < node->ref_count; ++r) {
+			uint32_t target = heap->refs[node->first_ref + r];
+			if (target != UNDEFINED) preds[pred_start[target] + fill[target]++] = i;
+		}
+	}
+
+	idom[0] = 0;
+	int changed = 1;
+	while (changed) {
+		changed = 0;
+		for (uint32_t i = count - 1; i-- > 0;) {
+			uint32_t node = order[i];
+			uint32_t new_idom = UNDEFINED;
+
+			for (uint32_t p = pred_start[node]; p < pred_start[node + 1]; ++p) {
+				uint32_t pred = preds[p];
+				if (idom[pred] == UNDEFINED) continue;
+				new_idom = new_idom == UNDEFINED ? pred : intersect(idom, post, pred, new_idom);
+			}
+
+			if (idom[node] != new_idom) {
+				idom[node] = new_idom;
+				changed = 1;
+			}
+		}
+	}
+
+	free(stack);
+	free(edge);
+	free(pred_start);
+	free(preds);
+	free(fill);
+
+	*reachable = count;
+	return order;
+}
+
+typedef struct Summary {
+	uint32_t key;
+	uint32_t count;
+	uint64_t shallow, retained;
+} Summary;
+
+static int compare_summary(const void* a, const void* b)
+{
+	uint64_t left = ((const Summary*)a)->retained, right = ((const Summary*)b)->retained;
+	return left < right ? 1 : left > right ? -1 : 0;
+}
+
+static Heap* sort_heap;
+static int compare_retained(const void* a, const void* b)
+{
+	uint64_t left = sort_heap->nodes[*(const uint32_t*)a].retained, right = sort_heap->nodes[*(const uint32_t*)b].retained;
+	return left < right ? 1 : left > right ? -1 : 0;
+}
+
+static void print_node(Heap* heap, uint32_t index)
+{
+	Node* node = heap->nodes + index;
+	printf("%s", heap->types[node->type]);
+	if (node->label && node->label[0]) printf(" '%s'", node->label);
+}
+
+static void report(Heap* heap, uint32_t* idom, uint32_t* order, uint32_t reachable, uint32_t top_count)
+{
+	uint64_t total = 0;
+	for (uint32_t i = 0; i < reachable; ++i) {
+		uint32_t node = order[i];
+		if (node != 0) total += heap->nodes[node].size;
+	}
+
+	printf("Heap: %u objects, %u references, %llu bytes\n\n", reachable - 1, heap->ref_count, (unsigned long long)total);
+
+	// By type - an object's retained size is only counted if it isn't already retained by an object of the same type
+	Summary types[MAX_TYPES];
+	memset(types, 0, sizeof(types));
+	for (uint32_t i = 0; i < heap->type_count; ++i) types[i].key = i;
+
+	for (uint32_t i = 0; i < reachable; ++i) {
+		uint32_t index = order[i];
+		if (index == 0) continue;
+		Node* node = heap->nodes + index;
+		Summary* summary = types + node->type;
+		summary->count++;
+		summary->shallow += node->size;
+		if (idom[index] == 0 || heap->nodes[idom[index]].type != node->type) summary->retained += node->retained;
+	}
+
+	qsort(types, heap->type_count, sizeof(Summary), compare_summary);
+	printf("%-14s %10s %14s %14s\n", "TYPE", "COUNT", "SHALLOW", "RETAINED");
+	for (uint32_t i = 0; i < heap->type_count; ++i) {
+		if (types[i].count == 0) continue;
+		printf("%-14s %10u %14llu %14llu\n", heap->types[types[i].key], types[i].count,
+			(unsigned long long)types[i].shallow, (unsigned long long)types[i].retained);
+	}
+
+	// By root
+	Summary roots[MAX_ROOT_NAMES];
+	memset(roots, 0, sizeof(roots));
+	for (uint32_t i = 0; i < heap->root_name_count; ++i) roots[i].key = i;
+
+	for (uint32_t i = 0; i < reachable; ++i) {
+		uint32_t index = order[i];
+		Node* node = heap->nodes + index;
+		if (index == 0 || idom[index] != 0 || node->root_name == UNDEFINED) continue;
+		roots[node->root_name].count++;
+		roots[node->root_name].shallow += node->size;
+		roots[node->root_name].retained += node->retained;
+	}
+
+	qsort(roots, heap->root_name_count, sizeof(Summary), compare_summary);
+	printf("\n%-20s %10s %14s\n", "ROOT", "OBJECTS", "RETAINED");
+	for (uint32_t i = 0; i < heap->root_name_count; ++i) {
+		if (roots[i].count == 0) continue;
+		printf("%-20s %10u %14llu\n", heap->root_name_table[roots[i].key], roots[i].count, (unsigned long long)roots[i].retained);
+	}
+
+	// By module, and the largest individual retainers
+	uint32_t* sorted = malloc(reachable * sizeof(uint32_t));
+	uint32_t sorted_count = 0;
+	for (uint32_t i = 0; i < reachable; ++i) {
+		if (order[i] != 0) sorted[sorted_count++] = order[i];
+	}
+
+	sort_heap = heap;
+	qsort(sorted, sorted_count, sizeof(uint32_t), compare_retained);
+
+	printf("\n%-40s %14s %14s\n", "MODULE", "SHALLOW", "RETAINED");
+	for (uint32_t i = 0; i < sorted_count; ++i) {
+		Node* node = heap->nodes + sorted[i];
+		if (strcmp(heap->types[node->type], "module") != 0) continue;
+		printf("%-40s %14llu %14llu\n", node->label && node->label[0] ? node->label : "<anonymous>",
+			(unsigned long long)node->size, (unsigned long long)node->retained);
+	}
+
+	printf("\nLARGEST RETAINERS\n");
+	for (uint32_t i = 0; i < sorted_count && i < top_count; ++i) {
+		uint32_t index = sorted[i];
+		printf("%14llu  ", (unsigned long long)heap->nodes[index].retained);
+		print_node(heap, index);
+
+		uint32_t depth = 0;
+		for (uint32_t dom = idom[index]; dom != 0 && depth < 8; dom = idom[dom], depth++) {
+			printf(" <- ");
+			print_node(heap, dom);
+		}
+
+		uint32_t top = index;
+		while (idom[top] != 0) top = idom[top];
+		if (heap->nodes[top].root_name != UNDEFINED) printf(" <- (%s)", heap->root_name_table[heap->nodes[top].root_name]);
+		printf("\n");
+	}
+
+	free(sorted);
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		printf("USAGE: bolt-heap snapshot.json [top_count]\n");
+		return 1;
+	}
+
+	uint32_t top_count = argc > 2 ? (uint32_t)atoi(argv[2]) : 20;
+
+	FILE* file = fopen(argv[1], "rb");
+	if (!file) {
+		printf("ERROR: Failed to open '%s'!\n", argv[1]);
+		return 1;
+	}
+
+	fseek(file, 0, SEEK_END);
+	long length = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	char* source = malloc(length + 1);
+	size_t read = fread(source, 1, length, file);
+	fclose(file);
+	source[read] = 0;
+
+	Heap heap;
+	memset(&heap, 0, sizeof(Heap));
+
+	// Node 0 is a synthetic root that references everything the gc treats as a root
+	heap.nodes = grow(heap.nodes, &heap.node_cap, 0, sizeof(Node));
+	memset(heap.nodes, 0, sizeof(Node));
+	heap.nodes[0].root_name = UNDEFINED;
+	heap.node_count = 1;
+
+	Parser parser = { source, source + read, NULL };
+	if (!parse_snapshot(&parser, &heap)) {
+		printf("ERROR: Failed to parse snapshot at offset %lld: %s!\n", (long long)(parser.cursor - source), parser.error);
+		return 1;
+	}
+
+	link_graph(&heap);
+
+	uint32_t* idom = malloc(heap.node_count * sizeof(uint32_t));
+	uint32_t* post = malloc(heap.node_count * sizeof(uint32_t));
+	uint32_t reachable = 0;
+	uint32_t* order = compute_dominators(&heap, idom, post, &reachable);
+
+	for (uint32_t i = 0; i < heap.node_count; ++i) {
+		heap.nodes[i].retained = heap.nodes[i].size;
+	}
+
+	// Postorder visits every node before its dominator, so retained sizes can be accumulated in a single pass
+	for (uint32_t i = 0; i < reachable; ++i) {
+		uint32_t node = order[i];
+		if (node != 0) heap.nodes[idom[node]].retained += heap.nodes[node].retained;
+	}
+
+	report(&heap, idom, order, reachable, top_count);
+
+	return 0;
+}
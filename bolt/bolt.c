@@ -15,14 +15,40 @@
 #include "bt_debug.h"
 #include "bt_gc.h"
 
+static void* handler_alloc(void* userdata, size_t size)
+{
+	return ((bt_Context*)userdata)->alloc(size);
+}
+
+static void* handler_realloc(void* userdata, void* ptr, size_t old_size, size_t new_size)
+{
+	return ((bt_Context*)userdata)->realloc(ptr, new_size);
+}
+
+static void handler_free(void* userdata, void* ptr, size_t size)
+{
+	((bt_Context*)userdata)->free(ptr);
+}
+
 void bt_open(bt_Context** context, bt_Handlers* handlers)
 {
-	*context = handlers->alloc(sizeof(bt_Context));
+	bt_Allocator allocator = handlers->allocator;
+	*context = allocator.alloc ? allocator.alloc(allocator.userdata, sizeof(bt_Context)) : handlers->alloc(sizeof(bt_Context));
 	bt_Context* ctx = *context;
 
 	ctx->alloc = handlers->alloc;
 	ctx->free = handlers->free;
 	ctx->realloc = handlers->realloc;
+
+	// The plain handlers are wrapped so everything internally goes through the sized interface
+	if (!allocator.alloc) {
+		allocator.alloc = handler_alloc;
+		allocator.realloc = handler_realloc;
+		allocator.free = handler_free;
+		allocator.userdata = ctx;
+	}
+
+	ctx->allocator = allocator;
 	ctx->on_error = handlers->on_error;
 
 	ctx->write = handlers->write;
@@ -33,9 +59,17 @@ void bt_open(bt_Context** context, bt_Handlers* handlers)
 
 	bt_make_gc(ctx);
 
-	for (uint32_t i = 0; i < BT_STRINGTABLE_SIZE; i++) {
-		bt_buffer_empty(&ctx->string_table[i]);
-	}
+	ctx->string_table.capacity = BT_STRINGTABLE_SIZE;
+	ctx->string_table.count = 0;
+	ctx->string_table.entries = bt_gc_alloc(ctx, sizeof(bt_StringTableEntry) * BT_STRINGTABLE_SIZE);
+	memset(ctx->string_table.entries, 0, sizeof(bt_StringTableEntry) * BT_STRINGTABLE_SIZE);
+	memset(ctx->byte_strings, 0, sizeof(ctx->byte_strings));
+	ctx->empty_string = NULL;
+	memset(ctx->small_int_strings, 0, sizeof(ctx->small_int_strings));
+	ctx->true_string = ctx->false_string = ctx->null_string = NULL;
+
+	memset(ctx->proto_cache, 0, sizeof(ctx->proto_cache));
+	ctx->proto_cache_epoch = 0;
 
 	ctx->n_allocated = 0;
 	ctx->next = 0;
@@ -92,6 +126,7 @@ void bt_open(bt_Context** context, bt_Handlers* handlers)
 	ctx->compiler_options.allow_method_hoisting = BT_TRUE;
 	ctx->compiler_options.predict_hash_slots = BT_TRUE;
 	ctx->compiler_options.typed_array_subscript = BT_TRUE;
+	ctx->compiler_options.cache_index_slots = BT_TRUE;
 
 	ctx->module_paths = NULL;
 	bt_append_module_path(ctx, "%s.bolt");
@@ -144,7 +179,7 @@ static char* bt_read_file(bt_Context* ctx, const char* path, void** handle)
 	uint32_t len = ftell(*handle);
 	fseek(*handle, 0, SEEK_SET);
 
-	char* code = ctx->alloc(len + 1);
+	char* code = ctx->allocator.alloc(ctx->allocator.userdata, len + 1);
 	fread(code, 1, len, *handle);
 	code[len] = 0;
 
@@ -158,7 +193,7 @@ static void bt_close_file(bt_Context* ctx, const char* path, void* handle)
 
 static void bt_free_source(bt_Context* ctx, char* source)
 {
-	ctx->free(source);
+	ctx->allocator.free(ctx->allocator.userdata, source, strlen(source) + 1);
 }
 #endif
 
@@ -216,12 +251,26 @@ void bt_close(bt_Context* context)
 	context->current_thread = 0;
 	context->native_references = 0;
 
-	for (uint32_t i = 0; i < BT_STRINGTABLE_SIZE; i++) {
-		bt_buffer_destroy(context, &context->string_table[i]);
-		bt_buffer_empty(&context->string_table[i]);
+	memset(context->byte_strings, 0, sizeof(context->byte_strings));
+	context->empty_string = 0;
+	memset(context->small_int_strings, 0, sizeof(context->small_int_strings));
+	context->true_string = 0;
+	context->false_string = 0;
+	context->null_string = 0;
+
+	// Arena objects are never swept, so anything left in an active arena is dropped wholesale first
+	if (bt_arena_is_active(context)) {
+		bt_arena_reset(context, context->gc.arena_base);
 	}
 
+	bt_gc_free(context, context->string_table.entries, sizeof(bt_StringTableEntry) * context->string_table.capacity);
+	context->string_table.entries = NULL;
+	context->string_table.capacity = 0;
+	context->string_table.count = 0;
+
+	bt_gc_set_sweep_step(context, 0);
 	while (bt_collect(&context->gc, 0));
+	bt_run_finalizers(context);
 
 	bt_free(context, context->root);
 
@@ -234,7 +283,9 @@ void bt_close(bt_Context* context)
 	}
 
 	bt_destroy_gc(context, &context->gc);
-	context->free(context);
+	
+	bt_Allocator allocator = context->allocator;
+	allocator.free(allocator.userdata, context, sizeof(bt_Context));
 }
 
 bt_bool bt_run(bt_Context* context, const char* source)
@@ -251,6 +302,9 @@ bt_Module* bt_compile_module(bt_Context* context, const char* source, const char
 	printf("-----------------------------------------------------\n");
 #endif
 	
+	// Nothing the compiler creates is rooted until the module is returned, so it can't be collected from under it
+	bt_gc_pause(context);
+
 	bt_Tokenizer tok = bt_open_tokenizer(context);
 	bt_tokenizer_set_source(&tok, source);
 	bt_tokenizer_set_source_name(&tok, mod_name);
@@ -273,6 +327,8 @@ bt_Module* bt_compile_module(bt_Context* context, const char* source, const char
 	bt_close_parser(&parser);
 	bt_close_tokenizer(&tok);
 
+	bt_gc_unpause(context);
+
 	return result;
 }
 
@@ -346,6 +402,11 @@ void bt_register_prelude(bt_Context* context, bt_Value name, bt_Type* type, bt_V
 
 void bt_register_module(bt_Context* context, bt_Value name, bt_Module* module)
 {
+	// Native modules are only ever named by registration, adopt it so they can be identified in dumps and snapshots
+	if (!module->name && BT_IS_OBJECT(name) && BT_OBJECT_GET_TYPE(BT_AS_OBJECT(name)) == BT_OBJECT_TYPE_STRING) {
+		module->name = (bt_String*)BT_AS_OBJECT(name);
+	}
+
 	bt_table_set(context, context->loaded_modules, name, BT_VALUE_OBJECT(module));
 }
 
@@ -390,10 +451,22 @@ static bt_Value bt_normalize_path(bt_Context* context, bt_Value path)
 		char_data[new_len--] = 0;
 	}
 	
-	result->len = new_len;
+	// The string's allocation is sized by its length, so a shortened path needs a copy of its own
+	if (new_len != result->len) {
+		bt_push_root(context, (bt_Object*)result);
+		bt_String* shortened = bt_make_string_len(context, char_data, new_len);
+		bt_pop_root(context);
+		result = shortened;
+	}
+
 	return BT_VALUE_OBJECT(result);
 }
 
+bt_Module* bt_find_registered_module(bt_Context* context, bt_Value name)
+{
+	return (bt_Module*)BT_AS_OBJECT(bt_table_get(context->loaded_modules, name));
+}
+
 bt_Module* bt_find_module(bt_Context* context, bt_Value name, bt_bool suppress_errors)
 {
 	bt_push_root(context, BT_AS_OBJECT(name));
@@ -410,7 +483,7 @@ bt_Module* bt_find_module(bt_Context* context, bt_Value name, bt_bool suppress_e
 
 		bt_Path* pathspec = context->module_paths;
 		while (pathspec && !code) {
-			path_len = sprintf(path_buf, pathspec->spec, BT_STRING_STR(to_load));
+			path_len = sprintf(path_buf, pathspec->spec, bt_string_cstr(context, to_load));
 	
 			if (path_len >= BT_MODULE_PATH_SIZE) {
 				if (!suppress_errors) bt_runtime_error(context->current_thread, "Path buffer overrun when loading module!", NULL);
@@ -508,6 +581,7 @@ bt_bool bt_execute_with_args(bt_Context* context, bt_Thread* thread, bt_Callable
 	bt_Thread* old_thread = context->current_thread;
 
 	bt_reset_thread(thread);
+	thread->parent = old_thread;
 	context->current_thread = thread;
 
 	bt_push(thread, BT_VALUE_OBJECT(callable));
@@ -519,10 +593,14 @@ bt_bool bt_execute_with_args(bt_Context* context, bt_Thread* thread, bt_Callable
 	int32_t result = setjmp(&thread->error_loc[0]);
 	if (result == 0) bt_call(thread, argc);
 	else {
+		// The error has been caught, so the memory limit applies again if it was what got raised
+		context->gc.limit_exceeded = BT_FALSE;
+		thread->parent = NULL;
 		context->current_thread = old_thread;
 		return BT_FALSE;
 	}
 
+	thread->parent = NULL;
 	context->current_thread = old_thread;
 	return BT_TRUE;
 }
@@ -610,13 +688,25 @@ void bt_call(bt_Thread* thread, uint8_t argc)
 	} break;
 	case BT_OBJECT_TYPE_CLOSURE: {
 		bt_Fn* callable = ((bt_Closure*)obj)->fn;
+		if (BT_OBJECT_GET_TYPE(callable) == BT_OBJECT_TYPE_NATIVE_FN) {
+			thread->callstack[thread->depth++] = BT_MAKE_STACKFRAME(obj, 0, 0);
+
+			thread->native_stack[thread->native_depth].return_loc = -1;
+			thread->native_stack[thread->native_depth].argc = argc;
+			thread->native_depth++;
+
+			((bt_NativeFn*)callable)->fn(thread->context, thread);
+			thread->native_depth--;
+			break;
+		}
+
 		thread->callstack[thread->depth++] = BT_MAKE_STACKFRAME(obj, callable->stack_size, 0);
 		call(thread->context, thread, callable->module, callable->instructions.elements, callable->constants.elements, -1);
 	} break;
 	case BT_OBJECT_TYPE_NATIVE_FN: {
 		thread->callstack[thread->depth++] = BT_MAKE_STACKFRAME(obj, 0, 0);
 
-		thread->native_stack[thread->native_depth].return_loc = -2;
+		thread->native_stack[thread->native_depth].return_loc = -1;
 		thread->native_stack[thread->native_depth].argc = argc;
 		thread->native_depth++;
 
@@ -718,46 +808,120 @@ uint32_t bt_get_debug_index(bt_Callable* callable, bt_Op* ip)
 	return 0;
 }
 
+static void string_table_insert(bt_StringTable* table, uint64_t hash, bt_String* str)
+{
+	uint32_t mask = table->capacity - 1;
+	uint32_t slot = (uint32_t)hash & mask;
+	while (table->entries[slot].string) slot = (slot + 1) & mask;
+
+	table->entries[slot].hash = hash;
+	table->entries[slot].string = str;
+	table->count++;
+}
+
+static void string_table_grow(bt_Context* ctx, bt_StringTable* table)
+{
+	bt_StringTableEntry* old_entries = table->entries;
+	uint32_t old_capacity = table->capacity;
+
+	bt_StringTableEntry* new_entries = bt_gc_alloc(ctx, sizeof(bt_StringTableEntry) * old_capacity * 2);
+	memset(new_entries, 0, sizeof(bt_StringTableEntry) * old_capacity * 2);
+
+	table->entries = new_entries;
+	table->capacity = old_capacity * 2;
+	table->count = 0;
+
+	for (uint32_t i = 0; i < old_capacity; ++i) {
+		if (old_entries[i].string) string_table_insert(table, old_entries[i].hash, old_entries[i].string);
+	}
+
+	bt_gc_free(ctx, old_entries, sizeof(bt_StringTableEntry) * old_capacity);
+}
+
+// Backward-shift deletion, moving later entries of the same run into the hole so no probe sequence is broken
+static void string_table_erase(bt_StringTable* table, uint32_t slot)
+{
+	uint32_t mask = table->capacity - 1;
+	uint32_t hole = slot;
+	uint32_t next = (hole + 1) & mask;
+
+	while (table->entries[next].string) {
+		uint32_t home = (uint32_t)table->entries[next].hash & mask;
+		if (((next - home) & mask) >= ((next - hole) & mask)) {
+			table->entries[hole] = table->entries[next];
+			hole = next;
+		}
+
+		next = (next + 1) & mask;
+	}
+
+	table->entries[hole].string = NULL;
+	table->entries[hole].hash = 0;
+	table->count--;
+}
+
 bt_String* bt_get_or_make_interned(bt_Context* ctx, const char* str, uint32_t len)
 {
 	uint64_t hash = bt_hash_str(str, len);
-	uint64_t bucket_idx = hash % BT_STRINGTABLE_SIZE;
-
-	bt_StringTableBucket* bucket = ctx->string_table + bucket_idx;
 
-	for (uint32_t i = 0; i < bucket->length; ++i) {
-		bt_StringTableEntry* entry = bucket->elements + i;
-		if (entry->hash == hash) return entry->string;
+	bt_StringTable* table = &ctx->string_table;
+	uint32_t mask = table->capacity - 1;
+	for (uint32_t slot = (uint32_t)hash & mask; table->entries[slot].string; slot = (slot + 1) & mask) {
+		bt_StringTableEntry* entry = table->entries + slot;
+		if (entry->hash == hash && entry->string->len == len && memcmp(BT_STRING_STR(entry->string), str, len) == 0) {
+			return entry->string;
+		}
 	}
 
-	bt_StringTableEntry new_entry;
-	new_entry.hash = hash;
-	new_entry.string = BT_ALLOCATE_INLINE_STORAGE(ctx, STRING, bt_String, len + 1);
-	memcpy(BT_STRING_STR(new_entry.string), str, len);
-	BT_STRING_STR(new_entry.string)[len] = 0;
-	new_entry.string->len = len;
-	new_entry.string->hash = hash;
-	new_entry.string->interned = 1;
-	bt_buffer_push(ctx, bucket, new_entry);
-
-	return new_entry.string;
+	// Interning would leave the string table pointing into the arena after a reset, so arena strings stay unique
+	if (ctx->gc.arena_depth) return bt_make_string_len_uninterned(ctx, str, len);
+
+	// Allocating may run a gc cycle, which purges the table, so the slot is found again once the string exists
+	bt_String* result = BT_ALLOCATE_INLINE_STORAGE(ctx, STRING, bt_String, len + 1);
+	memcpy(BT_STRING_STR(result), str, len);
+	BT_STRING_STR(result)[len] = 0;
+	result->len = len;
+	result->hash = hash;
+	result->interned = 1;
+
+	if ((table->count + 1) * 2 > table->capacity) string_table_grow(ctx, table);
+	string_table_insert(table, hash, result);
+
+	return result;
 }
 
 void bt_remove_interned(bt_Context* ctx, bt_String* str)
 {
-	uint64_t bucket_idx = str->hash % BT_STRINGTABLE_SIZE;
-
-	bt_StringTableBucket* bucket = ctx->string_table + bucket_idx;
-	for (uint32_t i = 0; i < bucket->length; ++i) {
-		bt_StringTableEntry* entry = bucket->elements + i;
-		if (entry->hash == str->hash) {
-			bucket->elements[i] = bucket->elements[bucket->length - 1];
-			bucket->length--;
+	bt_StringTable* table = &ctx->string_table;
+	if (!str->interned || table->count == 0) return;
+
+	uint32_t mask = table->capacity - 1;
+	for (uint32_t slot = (uint32_t)str->hash & mask; table->entries[slot].string; slot = (slot + 1) & mask) {
+		if (table->entries[slot].string == str) {
+			string_table_erase(table, slot);
 			return;
 		}
 	}
 }
 
+void bt_purge_interned(bt_Context* ctx)
+{
+	bt_StringTable* table = &ctx->string_table;
+	if (table->count == 0) return;
+
+	// Starting right after an empty slot means no run wraps around past the scan, so entries shifted back by an erase are always still ahead of it
+	uint32_t mask = table->capacity - 1;
+	uint32_t start = 0;
+	while (table->entries[start].string) start++;
+
+	for (uint32_t i = 1; i <= table->capacity; ++i) {
+		uint32_t slot = (start + i) & mask;
+		while (table->entries[slot].string && !BT_OBJECT_GET_MARK((bt_Object*)table->entries[slot].string)) {
+			string_table_erase(table, slot);
+		}
+	}
+}
+
 #define XSTR(x) #x
 #define ARITH_MF(name)                                                                               \
 if (BT_IS_OBJECT(lhs)) {																			 \
@@ -882,6 +1046,33 @@ static BT_NO_INLINE void bt_mfneq(bt_Thread* thread, bt_Value* __restrict result
 	bt_runtime_error(thread, "Cannot neq non-number value!", ip);
 }
 
+// Slot cache misses for constant-key indexing, `ext` holding the slot the key was last found at
+static BT_NO_INLINE bt_Value bt_load_cached(bt_Context* context, bt_Object* obj, bt_Value key, bt_Op* ext)
+{
+	if (BT_OBJECT_GET_TYPE(obj) == BT_OBJECT_TYPE_TABLE) {
+		int32_t slot = bt_table_get_idx((bt_Table*)obj, key);
+		if (slot >= 0 && (BT_TABLE_PAIRS(obj) + slot)->key == key) {
+			// Only the low 16 bits fit in the ext op, later slots are looked up every time
+			if (slot <= UINT16_MAX) BT_SET_IBC(*ext, slot);
+			return (BT_TABLE_PAIRS(obj) + slot)->value;
+		}
+	}
+
+	return bt_get(context, obj, key);
+}
+
+static BT_NO_INLINE void bt_store_cached(bt_Context* context, bt_Object* obj, bt_Value key, bt_Value value, bt_Op* ext)
+{
+	bt_set(context, obj, key, value);
+
+	if (BT_OBJECT_GET_TYPE(obj) == BT_OBJECT_TYPE_TABLE) {
+		int32_t slot = bt_table_get_idx((bt_Table*)obj, key);
+		if (slot >= 0 && slot <= UINT16_MAX && (BT_TABLE_PAIRS(obj) + slot)->key == key) {
+			BT_SET_IBC(*ext, slot);
+		}
+	}
+}
+
 static void call(bt_Context* context, bt_Thread* thread, bt_Module* module, bt_Op* ip, bt_Value* constants, int8_t return_loc)
 {
 	bt_Value* stack = thread->stack + thread->top;
@@ -1019,11 +1210,11 @@ static void call(bt_Context* context, bt_Thread* thread, bt_Module* module, bt_O
 			
 		CASE(TABLE): 
 			if (BT_IS_ACCELERATED(op)) {
-				obj = (bt_Object*)BT_AS_OBJECT(stack[BT_GET_C(op)]);
-				obj2 = (bt_Object*)BT_ALLOCATE_INLINE_STORAGE(context, TABLE, bt_Table, (sizeof(bt_TablePair) * BT_GET_B(op)) - sizeof(bt_Value));
-				memcpy((char*)obj2 + sizeof(bt_Object), 
-					((char*)((bt_Type*)obj)->as.table_shape.tmpl) + sizeof(bt_Object),
-					(sizeof(bt_Table) - sizeof(bt_Object)) + (sizeof(bt_TablePair) * (BT_GET_B(op))) - sizeof(bt_Value));
+				// Sized by the template rather than the literal, as the two can disagree once a shape has grown
+				obj = (bt_Object*)((bt_Type*)BT_AS_OBJECT(stack[BT_GET_C(op)]))->as.table_shape.tmpl;
+				obj2 = (bt_Object*)BT_ALLOCATE_INLINE_STORAGE(context, TABLE, bt_Table, BT_TABLE_INLINE_STORAGE(((bt_Table*)obj)->inline_capacity));
+				memcpy((char*)obj2 + sizeof(bt_Object), (char*)obj + sizeof(bt_Object),
+					(sizeof(bt_Table) - sizeof(bt_Object)) + BT_TABLE_INLINE_STORAGE(((bt_Table*)obj)->inline_capacity));
 				stack[BT_GET_A(op)] = BT_VALUE_OBJECT(obj2);
 			}
 			else stack[BT_GET_A(op)] = BT_VALUE_OBJECT(bt_make_table(context, BT_GET_IBC(op))); 
@@ -1031,10 +1222,11 @@ static void call(bt_Context* context, bt_Thread* thread, bt_Module* module, bt_O
 
 		CASE(ARRAY):
 			obj = (bt_Object*)bt_make_array(context, BT_GET_IBC(op));
-			((bt_Array*)obj)->length = BT_GET_IBC(op);
 			stack[BT_GET_A(op)] = BT_VALUE_OBJECT(obj);
 		NEXT;
 
+		CASE(APPEND_N): bt_array_append_n(context, (bt_Array*)BT_AS_OBJECT(stack[BT_GET_A(op)]), stack + BT_GET_B(op), BT_GET_C(op)); NEXT;
+
 		CASE(EXPORT): bt_module_export(context, module, (bt_Type*)BT_AS_OBJECT(stack[BT_GET_C(op)]), stack[BT_GET_A(op)], stack[BT_GET_B(op)]); NEXT;
 
 		CASE(CLOSE):
@@ -1048,10 +1240,34 @@ static void call(bt_Context* context, bt_Thread* thread, bt_Module* module, bt_O
 			stack[BT_GET_A(op)] = BT_VALUE_OBJECT(obj2);
 		NEXT;
 
-		CASE(LOAD_IDX_K): stack[BT_GET_A(op)] = bt_get(context, BT_AS_OBJECT(stack[BT_GET_B(op)]), constants[BT_GET_C(op)]); NEXT;
-		CASE(STORE_IDX_K): bt_set(context, BT_AS_OBJECT(stack[BT_GET_A(op)]), constants[BT_GET_B(op)], stack[BT_GET_C(op)]); NEXT;
+		CASE(LOAD_IDX_K):
+			obj = BT_AS_OBJECT(stack[BT_GET_B(op)]);
+			if (BT_IS_ACCELERATED(op)) {
+				// The ext op caches the slot the key was last found at, which holds for any table that has the same key there
+				obj2 = (bt_Object*)(uintptr_t)BT_GET_UBC(*(ip + 1));
+				if (BT_OBJECT_GET_TYPE(obj) == BT_OBJECT_TYPE_TABLE && (uint32_t)(uintptr_t)obj2 < ((bt_Table*)obj)->length
+					&& (BT_TABLE_PAIRS(obj) + (uintptr_t)obj2)->key == constants[BT_GET_C(op)]) {
+					stack[BT_GET_A(op)] = (BT_TABLE_PAIRS(obj) + (uintptr_t)obj2)->value;
+				}
+				else stack[BT_GET_A(op)] = bt_load_cached(context, obj, constants[BT_GET_C(op)], ip + 1);
+				ip++; // skip the ext op
+			} else stack[BT_GET_A(op)] = bt_get(context, obj, constants[BT_GET_C(op)]);
+		NEXT;
+
+		CASE(STORE_IDX_K):
+			obj = BT_AS_OBJECT(stack[BT_GET_A(op)]);
+			if (BT_IS_ACCELERATED(op)) {
+				obj2 = (bt_Object*)(uintptr_t)BT_GET_UBC(*(ip + 1));
+				if (BT_OBJECT_GET_TYPE(obj) == BT_OBJECT_TYPE_TABLE && (uint32_t)(uintptr_t)obj2 < ((bt_Table*)obj)->length
+					&& (BT_TABLE_PAIRS(obj) + (uintptr_t)obj2)->key == constants[BT_GET_B(op)]) {
+					(BT_TABLE_PAIRS(obj) + (uintptr_t)obj2)->value = stack[BT_GET_C(op)];
+				}
+				else bt_store_cached(context, obj, constants[BT_GET_B(op)], stack[BT_GET_C(op)], ip + 1);
+				ip++; // skip the ext op
+			} else bt_set(context, obj, constants[BT_GET_B(op)], stack[BT_GET_C(op)]);
+		NEXT;
 
-		CASE(LOAD_PROTO): stack[BT_GET_A(op)] = bt_table_get(((bt_Table*)BT_AS_OBJECT(stack[BT_GET_B(op)]))->prototype, constants[BT_GET_C(op)]); NEXT;
+		CASE(LOAD_PROTO): stack[BT_GET_A(op)] = bt_table_get_cached(context, ((bt_Table*)BT_AS_OBJECT(stack[BT_GET_B(op)]))->prototype, constants[BT_GET_C(op)]); NEXT;
 
 		CASE(EXPECT):   stack[BT_GET_A(op)] = stack[BT_GET_B(op)]; if (stack[BT_GET_A(op)] == BT_VALUE_NULL) bt_runtime_error(thread, "Operator '!' failed - lhs was null!", ip); NEXT;
 		CASE(COALESCE): stack[BT_GET_A(op)] = stack[BT_GET_B(op)] == BT_VALUE_NULL ? stack[BT_GET_C(op)] : stack[BT_GET_B(op)]; NEXT;
@@ -1199,6 +1415,8 @@ static void call(bt_Context* context, bt_Thread* thread, bt_Module* module, bt_O
 		CASE(LOAD_SUB_F): stack[BT_GET_A(op)] = bt_array_get(context, (bt_Array*)BT_AS_OBJECT(stack[BT_GET_B(op)]), (uint64_t)BT_AS_NUMBER(stack[BT_GET_C(op)])); NEXT;
 		CASE(STORE_SUB_F): bt_array_set(context, (bt_Array*)BT_AS_OBJECT(stack[BT_GET_A(op)]), (uint64_t)BT_AS_NUMBER(stack[BT_GET_B(op)]), stack[BT_GET_C(op)]); NEXT;
 		CASE(APPEND_F): bt_array_push(context, (bt_Array*)BT_AS_OBJECT(stack[BT_GET_A(op)]), stack[BT_GET_B(op)]); NEXT;
+		CASE(LOAD_BUF_F): stack[BT_GET_A(op)] = bt_typed_buffer_get(thread, (bt_TypedBuffer*)bt_userdata_get((bt_Userdata*)BT_AS_OBJECT(stack[BT_GET_B(op)])), (uint64_t)BT_AS_NUMBER(stack[BT_GET_C(op)])); NEXT;
+		CASE(STORE_BUF_F): bt_typed_buffer_set(thread, (bt_TypedBuffer*)bt_userdata_get((bt_Userdata*)BT_AS_OBJECT(stack[BT_GET_A(op)])), (uint64_t)BT_AS_NUMBER(stack[BT_GET_B(op)]), stack[BT_GET_C(op)]); NEXT;
 
 		CASE(IDX_EXT):;
 #ifndef BOLT_USE_INLINE_THREADING
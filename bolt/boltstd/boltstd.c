@@ -6,8 +6,10 @@
 #include "boltstd_meta.h"
 #include "boltstd_strings.h"
 #include "boltstd_io.h"
+#include "boltstd_buffers.h"
 #include "boltstd_tables.h"
 #include "boltstd_regex.h"
+#include "boltstd_iter.h"
 
 void boltstd_open_all(bt_Context* context)
 {
@@ -17,6 +19,8 @@ void boltstd_open_all(bt_Context* context)
 	boltstd_open_arrays(context);
 	boltstd_open_tables(context);
 	boltstd_open_strings(context);
+	boltstd_open_buffers(context);
 	boltstd_open_io(context);
 	boltstd_open_regex(context);
+	boltstd_open_iter(context);
 }
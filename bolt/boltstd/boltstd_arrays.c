@@ -5,16 +5,23 @@
 #include <stdlib.h>
 #include <memory.h>
 
+// Fetches an array argument with its items and length up to date, in case it's a view
+static bt_Array* arg_array(bt_Thread* thread, uint8_t idx)
+{
+	bt_Array* arr = (bt_Array*)bt_object(bt_arg(thread, idx));
+	BT_ARRAY_SYNC(arr);
+	return arr;
+}
+
 static void bt_arr_length(bt_Context* ctx, bt_Thread* thread)
 {
-	bt_Value arg = bt_arg(thread, 0);
-	bt_Array* as_arr = (bt_Array*)BT_AS_OBJECT(arg);
+	bt_Array* as_arr = arg_array(thread, 0);
 	bt_return(thread, BT_VALUE_NUMBER(as_arr->length));
 }
 
 static void bt_arr_pop(bt_Context* ctx, bt_Thread* thread)
 {
-	bt_Array* as_arr = (bt_Array*	)BT_AS_OBJECT(bt_arg(thread, 0));
+	bt_Array* as_arr = arg_array(thread, 0);
 	bt_return(thread, bt_array_pop(as_arr));
 }
 
@@ -31,7 +38,7 @@ static bt_Type* bt_arr_pop_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
 
 static void bt_arr_push(bt_Context* ctx, bt_Thread* thread)
 {
-	bt_Array* as_arr = (bt_Array*)BT_AS_OBJECT(bt_arg(thread, 0));
+	bt_Array* as_arr = arg_array(thread, 0);
 	bt_Value to_push = bt_arg(thread, 1);
 	bt_array_push(ctx, as_arr, to_push);
 }
@@ -63,6 +70,7 @@ static void bt_arr_each_iter(bt_Context* ctx, bt_Thread* thread)
 {
 	bt_Array* arr = (bt_Array*)BT_AS_OBJECT(bt_getup(thread, 0));
 	bt_number idx = BT_AS_NUMBER(bt_getup(thread, 1));
+	BT_ARRAY_SYNC(arr);
 
 	if (idx >= arr->length) {
 		bt_return(thread, BT_VALUE_NULL);
@@ -109,7 +117,7 @@ static bt_Type* bt_arr_clone_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
 
 static void bt_arr_reverse(bt_Context* ctx, bt_Thread* thread)
 {
-	bt_Array* arr = (bt_Array*)bt_object(bt_arg(thread, 0));
+	bt_Array* arr = arg_array(thread, 0);
 
 	uint32_t i = arr->length - 1;
 	uint32_t j = 0;
@@ -127,7 +135,7 @@ static void bt_arr_reverse(bt_Context* ctx, bt_Thread* thread)
 
 static void bt_arr_clone(bt_Context* ctx, bt_Thread* thread)
 {
-	bt_Array* arr = (bt_Array*)bt_object(bt_arg(thread, 0));
+	bt_Array* arr = arg_array(thread, 0);
 
 	bt_Array* clone = bt_make_array(ctx, arr->length);
 	clone->length = arr->length;
@@ -159,7 +167,7 @@ static bt_Type* bt_arr_map_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
 
 static void bt_arr_map(bt_Context* ctx, bt_Thread* thread)
 {
-	bt_Array* arg = (bt_Array*)bt_object(bt_arg(thread, 0));
+	bt_Array* arg = arg_array(thread, 0);
 	bt_Value applicator = bt_arg(thread, 1);
 
 	bt_Array* result = bt_make_array(ctx, arg->length);
@@ -169,6 +177,7 @@ static void bt_arr_map(bt_Context* ctx, bt_Thread* thread)
 		bt_push(thread, applicator);
 		bt_push(thread, arg->items[i]);
 		bt_call(thread, 1);
+		BT_ARRAY_SYNC(arg);
 
 		bt_Value mapped = bt_pop(thread);
 		bt_array_push(ctx, result, mapped);
@@ -201,7 +210,7 @@ static bt_Type* bt_arr_filter_type(bt_Context* ctx, bt_Type** args, uint8_t argc
 
 static void bt_arr_filter(bt_Context* ctx, bt_Thread* thread)
 {
-	bt_Array* arg = (bt_Array*)bt_object(bt_arg(thread, 0));
+	bt_Array* arg = arg_array(thread, 0);
 	bt_Value filter = bt_arg(thread, 1);
 
 	bt_Array* result = bt_make_array(ctx, arg->length / 2);
@@ -211,6 +220,7 @@ static void bt_arr_filter(bt_Context* ctx, bt_Thread* thread)
 		bt_push(thread, filter);
 		bt_push(thread, arg->items[i]);
 		bt_call(thread, 1);
+		BT_ARRAY_SYNC(arg);
 
 		bt_Value filtered = bt_pop(thread);
 		if (filtered == BT_VALUE_TRUE) {
@@ -236,58 +246,170 @@ static bt_Type* bt_arr_slice_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
 
 static void bt_arr_slice(bt_Context* ctx, bt_Thread* thread)
 {
-	bt_Array* arr = (bt_Array*)bt_object(bt_arg(thread, 0));
+	bt_Array* arr = arg_array(thread, 0);
 	uint32_t start = (uint32_t)bt_get_number(bt_arg(thread, 1));
 	uint32_t length = (uint32_t)bt_get_number(bt_arg(thread, 2));
 
 	if (start < 0 || start >= arr->length) bt_runtime_error(thread, "Slice start index outside of array bounds", NULL);
 	if (start + length > arr->length) bt_runtime_error(thread, "Slice extends past end of array", NULL);
 
-	bt_Array* result = bt_make_array(ctx, (uint16_t)length);
-	bt_push_root(ctx, (bt_Object*)result);
-
-	for (uint32_t i = start; i < start + length; ++i) {
-		bt_array_push(ctx, result, arr->items[i]);
-	}
+	bt_Array* result = bt_make_array(ctx, length);
+	if (length) memcpy(result->items, arr->items + start, sizeof(bt_Value) * length);
+	result->length = length;
 
 	bt_return(thread, BT_VALUE_OBJECT(result));
-	bt_pop_root(ctx);
 }
 
-typedef struct bt_SortCtx
+static void bt_arr_view(bt_Context* ctx, bt_Thread* thread)
 {
-	bt_Context* context;
-	bt_Thread* thread;
-	bt_Value comp_fn;
-	bt_bool in_use;
-} bt_SortCtx;
+	bt_Array* arr = arg_array(thread, 0);
+	bt_number start = bt_get_number(bt_arg(thread, 1));
+	bt_number length = bt_get_number(bt_arg(thread, 2));
 
-static bt_SortCtx sort_context;
+	// Unlike slices, empty views are allowed at the very end, so halving a range never has to special-case it
+	if (start < 0 || start > arr->length) bt_runtime_error(thread, "View start index outside of array bounds", NULL);
+	if (length < 0 || start + length > arr->length) bt_runtime_error(thread, "View extends past end of array", NULL);
 
-static int bt_sort_comp(const void* in_a, const void* in_b)
-{
-	bt_Value a = *(bt_Value*)in_a;
-	bt_Value b = *(bt_Value*)in_b;
+	bt_return(thread, BT_VALUE_OBJECT(bt_make_array_view(ctx, arr, (uint32_t)start, (uint32_t)length)));
+}
 
-	bt_push(sort_context.thread, sort_context.comp_fn);
-	bt_push(sort_context.thread, a);
-	bt_push(sort_context.thread, b);
-	bt_call(sort_context.thread, 2);
+// Below this many elements, partitions are finished with an insertion sort
+#define BT_SORT_INSERTION_THRESHOLD 16
+
+// Generates an introsort over `T`: a median-of-three quicksort that switches to heapsort once the partitions
+// stop shrinking evenly, leaving small ranges to insertion sort. `LESS(state, a, b)` is expanded inline.
+// Every scan is bounds checked, so a comparator that isn't a strict weak ordering can't walk off the array
+#define BT_DEFINE_SORT(name, T, STATE, LESS)                                                                 \
+	static void name##_insertion(STATE* state, T* items, uint32_t length)                                    \
+	{                                                                                                        \
+		for (uint32_t i = 1; i < length; ++i) {                                                              \
+			T value = items[i];                                                                              \
+			uint32_t j = i;                                                                                  \
+			while (j > 0 && LESS(state, value, items[j - 1])) {                                              \
+				items[j] = items[j - 1];                                                                     \
+				j--;                                                                                         \
+			}                                                                                                \
+			items[j] = value;                                                                                \
+		}                                                                                                    \
+	}                                                                                                        \
+                                                                                                             \
+	static void name##_sift(STATE* state, T* items, uint32_t root, uint32_t length)                          \
+	{                                                                                                        \
+		T value = items[root];                                                                               \
+		for (;;) {                                                                                           \
+			uint32_t child = root * 2 + 1;                                                                   \
+			if (child >= length) break;                                                                      \
+			if (child + 1 < length && LESS(state, items[child], items[child + 1])) child++;                  \
+			if (!LESS(state, value, items[child])) break;                                                    \
+			items[root] = items[child];                                                                      \
+			root = child;                                                                                    \
+		}                                                                                                    \
+		items[root] = value;                                                                                 \
+	}                                                                                                        \
+                                                                                                             \
+	static void name##_heapsort(STATE* state, T* items, uint32_t length)                                     \
+	{                                                                                                        \
+		for (uint32_t i = length / 2; i > 0; --i) name##_sift(state, items, i - 1, length);                  \
+		for (uint32_t i = length - 1; i > 0; --i) {                                                          \
+			T top = items[0]; items[0] = items[i]; items[i] = top;                                           \
+			name##_sift(state, items, 0, i);                                                                 \
+		}                                                                                                    \
+	}                                                                                                        \
+                                                                                                             \
+	static void name##_intro(STATE* state, T* items, uint32_t length, uint32_t depth)                        \
+	{                                                                                                        \
+		while (length > BT_SORT_INSERTION_THRESHOLD) {                                                       \
+			if (depth == 0) {                                                                                \
+				name##_heapsort(state, items, length);                                                       \
+				return;                                                                                      \
+			}                                                                                                \
+			depth--;                                                                                         \
+                                                                                                             \
+			uint32_t mid = length / 2, last = length - 1;                                                    \
+			T temp;                                                                                          \
+			if (LESS(state, items[mid], items[0])) { temp = items[mid]; items[mid] = items[0]; items[0] = temp; } \
+			if (LESS(state, items[last], items[mid])) {                                                      \
+				temp = items[mid]; items[mid] = items[last]; items[last] = temp;                             \
+				if (LESS(state, items[mid], items[0])) { temp = items[mid]; items[mid] = items[0]; items[0] = temp; } \
+			}                                                                                                \
+                                                                                                             \
+			T pivot = items[mid];                                                                            \
+			uint32_t i = 0, j = last;                                                                        \
+			for (;;) {                                                                                       \
+				do { i++; } while (i < last && LESS(state, items[i], pivot));                                \
+				do { j--; } while (j > 0 && LESS(state, pivot, items[j]));                                   \
+				if (i >= j) break;                                                                           \
+				temp = items[i]; items[i] = items[j]; items[j] = temp;                                       \
+			}                                                                                                \
+                                                                                                             \
+			/* Both halves are non-empty, recurse into the smaller one to bound the stack depth */           \
+			if (i < length - i) {                                                                            \
+				name##_intro(state, items, i, depth);                                                        \
+				items += i;                                                                                  \
+				length -= i;                                                                                 \
+			}                                                                                                \
+			else {                                                                                           \
+				name##_intro(state, items + i, length - i, depth);                                           \
+				length = i;                                                                                  \
+			}                                                                                                \
+		}                                                                                                    \
+                                                                                                             \
+		name##_insertion(state, items, length);                                                              \
+	}                                                                                                        \
+                                                                                                             \
+	static void name(STATE* state, T* items, uint32_t length)                                                \
+	{                                                                                                        \
+		uint32_t depth = 0;                                                                                  \
+		for (uint32_t n = length; n > 1; n >>= 1) depth += 2;                                                \
+		name##_intro(state, items, length, depth);                                                           \
+	}
 
-	bt_Value result = bt_pop(sort_context.thread);
-	if (result == BT_VALUE_TRUE) return -1;
+static BT_FORCE_INLINE bt_bool sort_string_less(bt_Value in_a, bt_Value in_b)
+{
+	bt_String* a = (bt_String*)BT_AS_OBJECT(in_a);
+	bt_String* b = (bt_String*)BT_AS_OBJECT(in_b);
 
-	return 1;
+	int32_t cmp = memcmp(BT_STRING_STR(a), BT_STRING_STR(b), a->len < b->len ? a->len : b->len);
+	return cmp < 0 || (cmp == 0 && a->len < b->len);
 }
 
-static int bt_sort_comp_nums(const void* in_a, const void* in_b)
+// All sort state lives on the C stack, so comparators are free to sort other arrays (or run on other contexts) themselves
+typedef struct bt_SortCall {
+	bt_Thread* thread;
+	bt_Value comp_fn;
+} bt_SortCall;
+
+static BT_FORCE_INLINE bt_bool sort_call_less(bt_SortCall* state, bt_Value a, bt_Value b)
 {
-	bt_number a = BT_AS_NUMBER(*(bt_Value*)in_a);
-	bt_number b = BT_AS_NUMBER(*(bt_Value*)in_b);
+	bt_push(state->thread, state->comp_fn);
+	bt_push(state->thread, a);
+	bt_push(state->thread, b);
+	bt_call(state->thread, 2);
 
-	return (a > b) - (a < b);
+	return bt_pop(state->thread) == BT_VALUE_TRUE;
 }
 
+// Ties in sort_by fall back to the original position, which keeps it stable
+typedef struct bt_SortKeyed {
+	bt_Value key;
+	bt_Value value;
+	uint32_t index;
+} bt_SortKeyed;
+
+#define SORT_NUMBER_LESS(state, a, b) (BT_AS_NUMBER(a) < BT_AS_NUMBER(b))
+#define SORT_STRING_LESS(state, a, b) (sort_string_less(a, b))
+#define SORT_CALL_LESS(state, a, b) (sort_call_less(state, a, b))
+#define SORT_KEYED_NUMBER_LESS(state, a, b) \
+	(BT_AS_NUMBER((a).key) < BT_AS_NUMBER((b).key) || (BT_AS_NUMBER((a).key) == BT_AS_NUMBER((b).key) && (a).index < (b).index))
+#define SORT_KEYED_STRING_LESS(state, a, b) \
+	(sort_string_less((a).key, (b).key) || (!sort_string_less((b).key, (a).key) && (a).index < (b).index))
+
+BT_DEFINE_SORT(sort_numbers, bt_Value, void, SORT_NUMBER_LESS)
+BT_DEFINE_SORT(sort_strings, bt_Value, void, SORT_STRING_LESS)
+BT_DEFINE_SORT(sort_custom, bt_Value, bt_SortCall, SORT_CALL_LESS)
+BT_DEFINE_SORT(sort_keyed_numbers, bt_SortKeyed, void, SORT_KEYED_NUMBER_LESS)
+BT_DEFINE_SORT(sort_keyed_strings, bt_SortKeyed, void, SORT_KEYED_STRING_LESS)
+
 static bt_Type* bt_arr_sort_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
 {
 	if (argc != 2 && argc != 1) return NULL;
@@ -295,6 +417,9 @@ static bt_Type* bt_arr_sort_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
 
 	if (arg->category != BT_TYPE_CATEGORY_ARRAY) return NULL;
 
+	bt_Type* inner = arg->as.array.inner;
+	bt_bool sorts_natively = inner == ctx->types.number || inner == ctx->types.string;
+
 	if (argc == 2) {
 		bt_Type* comparer = bt_type_dealias(args[1]);
 
@@ -309,11 +434,11 @@ static bt_Type* bt_arr_sort_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
 				comparer->as.fn.args.elements[1], arg->as.array.inner)) return NULL;
 		}
 		else {
-			if (arg->as.array.inner != ctx->types.number) return NULL;
+			if (!sorts_natively) return NULL;
 		}
 	}
 	else {
-		if (arg->as.array.inner != ctx->types.number) return NULL;
+		if (!sorts_natively) return NULL;
 	}
 
 	return bt_make_signature_type(ctx, arg, args, argc);
@@ -321,28 +446,103 @@ static bt_Type* bt_arr_sort_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
 
 static void bt_arr_sort(bt_Context* ctx, bt_Thread* thread)
 {
-	bt_Array* arg = (bt_Array*)bt_object(bt_arg(thread, 0));
+	bt_Array* arg = arg_array(thread, 0);
 	bt_Value sorter = bt_argc(thread) == 2 ? bt_arg(thread, 1) : BT_VALUE_NULL;
 
-	// only allowed for number fast case
+	// Without a comparator the array is known to hold only numbers or only strings
 	if (sorter == BT_VALUE_NULL) {
-		qsort(arg->items, arg->length, sizeof(bt_Value), bt_sort_comp_nums);
+		if (arg->length > 0 && BT_IS_NUMBER(arg->items[0])) {
+			sort_numbers(NULL, arg->items, arg->length);
+		}
+		else {
+			sort_strings(NULL, arg->items, arg->length);
+		}
 	}
 	else {
-		if (sort_context.in_use == BT_TRUE) {
-			bt_runtime_error(thread, "Cannot nest sorts!", NULL);
+		// The comparator can reach (and resize) the array, so sort a private copy and write it back afterwards
+		uint32_t length = arg->length;
+		bt_Array* scratch = bt_make_array(ctx, length);
+		bt_push_root(ctx, (bt_Object*)scratch);
+		memcpy(scratch->items, arg->items, sizeof(bt_Value) * length);
+		scratch->length = length;
+
+		bt_SortCall state = { thread, sorter };
+		sort_custom(&state, scratch->items, length);
+
+		BT_ARRAY_SYNC(arg);
+		if (length > arg->length) length = arg->length;
+		memcpy(arg->items, scratch->items, sizeof(bt_Value) * length);
+		bt_pop_root(ctx);
+	}
+
+	bt_return(thread, BT_VALUE_OBJECT(arg));
+}
+
+static bt_Type* bt_arr_sort_by_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
+{
+	if (argc != 2) return NULL;
+	bt_Type* arg = bt_type_dealias(args[0]);
+
+	if (arg->category != BT_TYPE_CATEGORY_ARRAY) return NULL;
+
+	bt_Type* key_fn = bt_type_dealias(args[1]);
+
+	if (key_fn->category != BT_TYPE_CATEGORY_SIGNATURE) return NULL;
+
+	bt_Type* key_type = key_fn->as.fn.return_type ? bt_type_dealias(key_fn->as.fn.return_type) : NULL;
+	if (key_type != ctx->types.number && key_type != ctx->types.string) return NULL;
+	if (key_fn->as.fn.args.length != 1) return NULL;
+	if (!key_fn->as.fn.args.elements[0]->satisfier(
+		key_fn->as.fn.args.elements[0], arg->as.array.inner)) return NULL;
+
+	return bt_make_signature_type(ctx, arg, args, 2);
+}
+
+static void bt_arr_sort_by(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Array* arg = arg_array(thread, 0);
+	bt_Value key_fn = bt_arg(thread, 1);
+	uint32_t length = arg->length;
+
+	// Every key is computed up front, once per element, and kept reachable while the rest are made
+	bt_Array* keys = bt_make_array(ctx, length);
+	bt_push_root(ctx, (bt_Object*)keys);
+
+	for (uint32_t i = 0; i < length && i < arg->length; ++i) {
+		bt_push(thread, key_fn);
+		bt_push(thread, arg->items[i]);
+		bt_call(thread, 1);
+		BT_ARRAY_SYNC(arg);
+
+		bt_array_push(ctx, keys, bt_pop(thread));
+	}
+
+	// The key function may have shrunk the array, only what's left is sorted
+	length = keys->length < arg->length ? keys->length : arg->length;
+
+	if (length > 1) {
+		// No script runs past this point, so the scratch buffer can't be leaked by a runtime error
+		bt_SortKeyed* keyed = bt_gc_alloc(ctx, sizeof(bt_SortKeyed) * length);
+		for (uint32_t i = 0; i < length; ++i) {
+			keyed[i] = (bt_SortKeyed) { keys->items[i], arg->items[i], i };
 		}
 
-		sort_context.in_use = BT_TRUE;
-		sort_context.comp_fn = sorter;
-		sort_context.context = ctx;
-		sort_context.thread = thread;
-		qsort(arg->items, arg->length, sizeof(bt_Value), bt_sort_comp);
-		
-		sort_context.in_use = BT_FALSE;
+		if (BT_IS_NUMBER(keyed[0].key)) {
+			sort_keyed_numbers(NULL, keyed, length);
+		}
+		else {
+			sort_keyed_strings(NULL, keyed, length);
+		}
+
+		for (uint32_t i = 0; i < length; ++i) {
+			arg->items[i] = keyed[i].value;
+		}
+
+		bt_gc_free(ctx, keyed, sizeof(bt_SortKeyed) * length);
 	}
 
 	bt_return(thread, BT_VALUE_OBJECT(arg));
+	bt_pop_root(ctx);
 }
 
 static bt_Type* bt_arr_reserve_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
@@ -359,13 +559,70 @@ static bt_Type* bt_arr_reserve_type(bt_Context* ctx, bt_Type** args, uint8_t arg
 
 static void bt_arr_reserve(bt_Context* ctx, bt_Thread* thread)
 {
-	bt_Array* arr = (bt_Array*)bt_object(bt_arg(thread, 0));
+	bt_Array* arr = arg_array(thread, 0);
 	uint64_t amt = (uint64_t)bt_get_number(bt_arg(thread, 1));
 	
 	uint64_t result = bt_array_reserve(ctx, arr, amt);
 	bt_return(thread, bt_make_number((bt_number)result));
 }
 
+static bt_Type* bt_arr_with_capacity_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
+{
+	if (argc != 2) return NULL;
+	bt_Type* arr = bt_type_dealias(args[0]);
+	bt_Type* amt = bt_type_dealias(args[1]);
+
+	if (arr->category != BT_TYPE_CATEGORY_ARRAY) return NULL;
+	if (amt != ctx->types.number) return NULL;
+
+	return bt_make_signature_type(ctx, arr, args, 2);
+}
+
+static void bt_arr_with_capacity(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Array* arr = arg_array(thread, 0);
+	bt_number amt = bt_get_number(bt_arg(thread, 1));
+	if (amt < 0) bt_runtime_error(thread, "Capacity can't be negative", NULL);
+
+	bt_array_reserve(ctx, arr, (uint64_t)amt);
+	bt_return(thread, BT_VALUE_OBJECT(arr));
+}
+
+static void bt_arr_capacity(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Array* arr = arg_array(thread, 0);
+	bt_return(thread, BT_VALUE_NUMBER(arr->capacity));
+}
+
+static bt_Type* bt_arr_resize_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
+{
+	if (argc != 3) return NULL;
+	bt_Type* arr = bt_type_dealias(args[0]);
+	if (arr->category != BT_TYPE_CATEGORY_ARRAY) return NULL;
+	if (bt_type_dealias(args[1]) != ctx->types.number) return NULL;
+	if (!arr->as.array.inner->satisfier(arr->as.array.inner, args[2])) return NULL;
+
+	bt_Type* newargs[] = { arr, ctx->types.number, arr->as.array.inner };
+	return bt_make_signature_type(ctx, arr, newargs, 3);
+}
+
+static void bt_arr_resize(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Array* arr = arg_array(thread, 0);
+	bt_number length = bt_get_number(bt_arg(thread, 1));
+	if (length < 0 || length > UINT32_MAX) bt_runtime_error(thread, "Array length out of range", NULL);
+
+	bt_array_resize(ctx, arr, (uint32_t)length, bt_arg(thread, 2));
+	bt_return(thread, BT_VALUE_OBJECT(arr));
+}
+
+static void bt_arr_shrink_to_fit(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Array* arr = arg_array(thread, 0);
+	uint64_t result = bt_array_shrink_to_fit(ctx, arr);
+	bt_return(thread, bt_make_number((bt_number)result));
+}
+
 static bt_Type* bt_arr_concatenate_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
 {
 	if (argc < 2) return NULL;
@@ -383,19 +640,20 @@ static bt_Type* bt_arr_concatenate_type(bt_Context* ctx, bt_Type** args, uint8_t
 
 static void bt_arr_concatenate(bt_Context* ctx, bt_Thread* thread)
 {
-	bt_Array* arr = (bt_Array*)bt_object(bt_arg(thread, 0));
+	bt_Array* arr = arg_array(thread, 0);
 
 	uint8_t argc = bt_argc(thread);
 	uint64_t total_cap = arr->length;
 	for (uint8_t i = 1; i < argc; i++) {
-		bt_Array* arg = (bt_Array*)bt_object(bt_arg(thread, i));
+		bt_Array* arg = arg_array(thread, i);
 		total_cap += arg->length;
 	}
 
 	bt_array_reserve(ctx, arr, total_cap);
 
+	// Sources are fetched again, a view of `arr` itself needs to see its new storage
 	for (uint8_t i = 1; i < argc; i++) {
-		bt_Array* arg = (bt_Array*)bt_object(bt_arg(thread, i));
+		bt_Array* arg = arg_array(thread, i);
 		memcpy(arr->items + arr->length, arg->items, sizeof(bt_Value) * arg->length);
 		arr->length += arg->length;
 	}
@@ -412,10 +670,11 @@ static bt_Type* bt_arr_flatten_type(bt_Context* ctx, bt_Type** args, uint8_t arg
 
 static void bt_arr_flatten(bt_Context* ctx, bt_Thread* thread)
 {
-	bt_Array* arr = (bt_Array*)bt_object(bt_arg(thread, 0));
+	bt_Array* arr = arg_array(thread, 0);
 	uint32_t total_cap = 0;
 	for (uint32_t i = 0; i < arr->length; i++) {
 		bt_Array* sub = (bt_Array*)bt_object(bt_array_get(ctx, arr, i));
+		BT_ARRAY_SYNC(sub);
 		total_cap += sub->length;
 	}
 
@@ -423,6 +682,7 @@ static void bt_arr_flatten(bt_Context* ctx, bt_Thread* thread)
 
 	for (uint32_t i = 0; i < arr->length; i++) {
 		bt_Array* sub = (bt_Array*)bt_object(bt_array_get(ctx, arr, i));
+		BT_ARRAY_SYNC(sub);
 		memcpy(result->items + result->length, sub->items, sizeof(bt_Value) * sub->length);
 		result->length += sub->length;
 	}
@@ -430,6 +690,270 @@ static void bt_arr_flatten(bt_Context* ctx, bt_Thread* thread)
 	bt_return(thread, bt_value((bt_Object*)result));
 }
 
+// Numeric kernels below read and write `[number]` storage directly, as an array known to hold only numbers
+// is a plain run of doubles. Each one keeps several independent accumulators so the adds can overlap
+#define NUMBERS(arr) ((double*)(arr)->items)
+
+static double kernel_sum(const double* x, uint32_t n)
+{
+	uint32_t i = 0;
+#ifdef BT_SIMD_SSE2
+	__m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd(), acc2 = _mm_setzero_pd(), acc3 = _mm_setzero_pd();
+	for (; i + 8 <= n; i += 8) {
+		acc0 = _mm_add_pd(acc0, _mm_loadu_pd(x + i));
+		acc1 = _mm_add_pd(acc1, _mm_loadu_pd(x + i + 2));
+		acc2 = _mm_add_pd(acc2, _mm_loadu_pd(x + i + 4));
+		acc3 = _mm_add_pd(acc3, _mm_loadu_pd(x + i + 6));
+	}
+
+	__m128d acc = _mm_add_pd(_mm_add_pd(acc0, acc1), _mm_add_pd(acc2, acc3));
+	double lanes[2];
+	_mm_storeu_pd(lanes, acc);
+	double total = lanes[0] + lanes[1];
+#else
+	double acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+	for (; i + 4 <= n; i += 4) {
+		acc0 += x[i]; acc1 += x[i + 1]; acc2 += x[i + 2]; acc3 += x[i + 3];
+	}
+
+	double total = (acc0 + acc1) + (acc2 + acc3);
+#endif
+
+	for (; i < n; i++) total += x[i];
+	return total;
+}
+
+static double kernel_dot(const double* x, const double* y, uint32_t n)
+{
+	uint32_t i = 0;
+#ifdef BT_SIMD_SSE2
+	__m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd(), acc2 = _mm_setzero_pd(), acc3 = _mm_setzero_pd();
+	for (; i + 8 <= n; i += 8) {
+		acc0 = _mm_add_pd(acc0, _mm_mul_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+		acc1 = _mm_add_pd(acc1, _mm_mul_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2)));
+		acc2 = _mm_add_pd(acc2, _mm_mul_pd(_mm_loadu_pd(x + i + 4), _mm_loadu_pd(y + i + 4)));
+		acc3 = _mm_add_pd(acc3, _mm_mul_pd(_mm_loadu_pd(x + i + 6), _mm_loadu_pd(y + i + 6)));
+	}
+
+	__m128d acc = _mm_add_pd(_mm_add_pd(acc0, acc1), _mm_add_pd(acc2, acc3));
+	double lanes[2];
+	_mm_storeu_pd(lanes, acc);
+	double total = lanes[0] + lanes[1];
+#else
+	double acc0 = 0, acc1 = 0, acc2 = 0, acc3 = 0;
+	for (; i + 4 <= n; i += 4) {
+		acc0 += x[i] * y[i]; acc1 += x[i + 1] * y[i + 1]; acc2 += x[i + 2] * y[i + 2]; acc3 += x[i + 3] * y[i + 3];
+	}
+
+	double total = (acc0 + acc1) + (acc2 + acc3);
+#endif
+
+	for (; i < n; i++) total += x[i] * y[i];
+	return total;
+}
+
+// y = a * x + y, elementwise. With `a` of 1 this is a plain elementwise add
+static void kernel_axpy(double a, const double* x, double* y, uint32_t n)
+{
+	uint32_t i = 0;
+#ifdef BT_SIMD_SSE2
+	__m128d va = _mm_set1_pd(a);
+	for (; i + 4 <= n; i += 4) {
+		_mm_storeu_pd(y + i, _mm_add_pd(_mm_mul_pd(va, _mm_loadu_pd(x + i)), _mm_loadu_pd(y + i)));
+		_mm_storeu_pd(y + i + 2, _mm_add_pd(_mm_mul_pd(va, _mm_loadu_pd(x + i + 2)), _mm_loadu_pd(y + i + 2)));
+	}
+#endif
+
+	for (; i < n; i++) y[i] = a * x[i] + y[i];
+}
+
+static void kernel_add(const double* x, double* y, uint32_t n)
+{
+	uint32_t i = 0;
+#ifdef BT_SIMD_SSE2
+	for (; i + 4 <= n; i += 4) {
+		_mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(x + i), _mm_loadu_pd(y + i)));
+		_mm_storeu_pd(y + i + 2, _mm_add_pd(_mm_loadu_pd(x + i + 2), _mm_loadu_pd(y + i + 2)));
+	}
+#endif
+
+	for (; i < n; i++) y[i] = x[i] + y[i];
+}
+
+static void kernel_scale(double a, double* x, uint32_t n)
+{
+	uint32_t i = 0;
+#ifdef BT_SIMD_SSE2
+	__m128d va = _mm_set1_pd(a);
+	for (; i + 4 <= n; i += 4) {
+		_mm_storeu_pd(x + i, _mm_mul_pd(va, _mm_loadu_pd(x + i)));
+		_mm_storeu_pd(x + i + 2, _mm_mul_pd(va, _mm_loadu_pd(x + i + 2)));
+	}
+#endif
+
+	for (; i < n; i++) x[i] = a * x[i];
+}
+
+// Expects `n` to be at least 1
+static void kernel_min_max(const double* x, uint32_t n, double* out_min, double* out_max)
+{
+	uint32_t i = 0;
+	double lo = x[0], hi = x[0];
+#ifdef BT_SIMD_SSE2
+	if (n >= 4) {
+		__m128d lo0 = _mm_loadu_pd(x), lo1 = _mm_loadu_pd(x + 2);
+		__m128d hi0 = lo0, hi1 = lo1;
+		for (i = 4; i + 4 <= n; i += 4) {
+			__m128d a = _mm_loadu_pd(x + i), b = _mm_loadu_pd(x + i + 2);
+			lo0 = _mm_min_pd(lo0, a); lo1 = _mm_min_pd(lo1, b);
+			hi0 = _mm_max_pd(hi0, a); hi1 = _mm_max_pd(hi1, b);
+		}
+
+		double lanes[2];
+		_mm_storeu_pd(lanes, _mm_min_pd(lo0, lo1));
+		lo = lanes[0] < lanes[1] ? lanes[0] : lanes[1];
+		_mm_storeu_pd(lanes, _mm_max_pd(hi0, hi1));
+		hi = lanes[0] > lanes[1] ? lanes[0] : lanes[1];
+	}
+#endif
+
+	for (; i < n; i++) {
+		if (x[i] < lo) lo = x[i];
+		if (x[i] > hi) hi = x[i];
+	}
+
+	*out_min = lo;
+	*out_max = hi;
+}
+
+static bt_bool is_number_array(bt_Context* ctx, bt_Type* type)
+{
+	type = bt_type_dealias(type);
+	return type->category == BT_TYPE_CATEGORY_ARRAY && type->as.array.inner == ctx->types.number;
+}
+
+static void check_same_length(bt_Thread* thread, bt_Array* a, bt_Array* b)
+{
+	if (a->length != b->length) bt_runtime_error(thread, "Array lengths don't match!", NULL);
+}
+
+static bt_Type* bt_arr_sum_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
+{
+	if (argc != 1 || !is_number_array(ctx, args[0])) return NULL;
+	return bt_make_signature_type(ctx, ctx->types.number, args, argc);
+}
+
+static void bt_arr_sum(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Array* arr = arg_array(thread, 0);
+	bt_return(thread, bt_make_number(kernel_sum(NUMBERS(arr), arr->length)));
+}
+
+static bt_Type* bt_arr_dot_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
+{
+	if (argc != 2 || !is_number_array(ctx, args[0]) || !is_number_array(ctx, args[1])) return NULL;
+	return bt_make_signature_type(ctx, ctx->types.number, args, argc);
+}
+
+static void bt_arr_dot(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Array* x = arg_array(thread, 0);
+	bt_Array* y = arg_array(thread, 1);
+	check_same_length(thread, x, y);
+
+	bt_return(thread, bt_make_number(kernel_dot(NUMBERS(x), NUMBERS(y), x->length)));
+}
+
+static bt_Type* bt_arr_min_max_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
+{
+	if (argc != 1 || !is_number_array(ctx, args[0])) return NULL;
+	return bt_make_signature_type(ctx, bt_type_dealias(args[0]), args, argc);
+}
+
+static void bt_arr_min_max(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Array* arr = arg_array(thread, 0);
+	bt_Array* result = bt_make_array(ctx, 2);
+
+	if (arr->length > 0) {
+		double lo, hi;
+		kernel_min_max(NUMBERS(arr), arr->length, &lo, &hi);
+		result->items[0] = bt_make_number(lo);
+		result->items[1] = bt_make_number(hi);
+		result->length = 2;
+	}
+
+	bt_return(thread, BT_VALUE_OBJECT(result));
+}
+
+static bt_Type* bt_arr_scale_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
+{
+	if (argc != 2 || !is_number_array(ctx, args[0]) || bt_type_dealias(args[1]) != ctx->types.number) return NULL;
+	return bt_make_signature_type(ctx, bt_type_dealias(args[0]), args, argc);
+}
+
+static void bt_arr_scale(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Array* arr = arg_array(thread, 0);
+	kernel_scale(bt_get_number(bt_arg(thread, 1)), NUMBERS(arr), arr->length);
+	bt_return(thread, BT_VALUE_OBJECT(arr));
+}
+
+static bt_Type* bt_arr_add_arrays_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
+{
+	if (argc != 2 || !is_number_array(ctx, args[0]) || !is_number_array(ctx, args[1])) return NULL;
+	return bt_make_signature_type(ctx, bt_type_dealias(args[0]), args, argc);
+}
+
+static void bt_arr_add_arrays(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Array* y = arg_array(thread, 0);
+	bt_Array* x = arg_array(thread, 1);
+	check_same_length(thread, x, y);
+
+	kernel_add(NUMBERS(x), NUMBERS(y), y->length);
+	bt_return(thread, BT_VALUE_OBJECT(y));
+}
+
+static bt_Type* bt_arr_axpy_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
+{
+	if (argc != 3 || !is_number_array(ctx, args[0]) || bt_type_dealias(args[1]) != ctx->types.number || !is_number_array(ctx, args[2])) return NULL;
+	return bt_make_signature_type(ctx, bt_type_dealias(args[0]), args, argc);
+}
+
+static void bt_arr_axpy(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Array* y = arg_array(thread, 0);
+	bt_number a = bt_get_number(bt_arg(thread, 1));
+	bt_Array* x = arg_array(thread, 2);
+	check_same_length(thread, x, y);
+
+	kernel_axpy(a, NUMBERS(x), NUMBERS(y), y->length);
+	bt_return(thread, BT_VALUE_OBJECT(y));
+}
+
+static bt_Type* bt_arr_fill_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
+{
+	if (argc != 2) return NULL;
+	bt_Type* arr = bt_type_dealias(args[0]);
+	if (arr->category != BT_TYPE_CATEGORY_ARRAY) return NULL;
+	if (!arr->as.array.inner->satisfier(arr->as.array.inner, args[1])) return NULL;
+
+	bt_Type* newargs[] = { arr, arr->as.array.inner };
+	return bt_make_signature_type(ctx, arr, newargs, 2);
+}
+
+static void bt_arr_fill(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Array* arr = arg_array(thread, 0);
+	bt_Value value = bt_arg(thread, 1);
+
+	bt_Value* items = arr->items;
+	for (uint32_t i = 0; i < arr->length; i++) items[i] = value;
+
+	bt_return(thread, BT_VALUE_OBJECT(arr));
+}
+
 void boltstd_open_arrays(bt_Context* context)
 {
 	bt_Module* module = bt_make_module(context);
@@ -482,15 +1006,45 @@ void boltstd_open_arrays(bt_Context* context)
 	bt_type_add_field(context, array, arr_slice_sig, BT_VALUE_CSTRING(context, "slice"), BT_VALUE_OBJECT(fn_ref));
 	bt_module_export(context, module, arr_slice_sig, BT_VALUE_CSTRING(context, "slice"), BT_VALUE_OBJECT(fn_ref));
 
+	bt_Type* arr_view_sig = bt_make_poly_signature_type(context, "view([T], number, number): [T]", bt_arr_slice_type);
+	fn_ref = bt_make_native(context, module, arr_view_sig, bt_arr_view);
+	bt_type_add_field(context, array, arr_view_sig, BT_VALUE_CSTRING(context, "view"), BT_VALUE_OBJECT(fn_ref));
+	bt_module_export(context, module, arr_view_sig, BT_VALUE_CSTRING(context, "view"), BT_VALUE_OBJECT(fn_ref));
+
 	bt_Type* arr_sort_sig = bt_make_poly_signature_type(context, "sort([T], null | fn(T, T): bool): [T]", bt_arr_sort_type);
 	fn_ref = bt_make_native(context, module, arr_sort_sig, bt_arr_sort);
 	bt_type_add_field(context, array, arr_sort_sig, BT_VALUE_CSTRING(context, "sort"), BT_VALUE_OBJECT(fn_ref));
 	bt_module_export(context, module, arr_sort_sig, BT_VALUE_CSTRING(context, "sort"), BT_VALUE_OBJECT(fn_ref));
 
+	bt_Type* arr_sort_by_sig = bt_make_poly_signature_type(context, "sort_by([T], fn(T): number | string): [T]", bt_arr_sort_by_type);
+	fn_ref = bt_make_native(context, module, arr_sort_by_sig, bt_arr_sort_by);
+	bt_type_add_field(context, array, arr_sort_by_sig, BT_VALUE_CSTRING(context, "sort_by"), BT_VALUE_OBJECT(fn_ref));
+	bt_module_export(context, module, arr_sort_by_sig, BT_VALUE_CSTRING(context, "sort_by"), BT_VALUE_OBJECT(fn_ref));
+
 	bt_Type* arr_reserve_sig = bt_make_poly_signature_type(context, "reserve([T], number): number", bt_arr_reserve_type);
 	fn_ref = bt_make_native(context, module, arr_reserve_sig, bt_arr_reserve);
 	bt_type_add_field(context, array, arr_reserve_sig, BT_VALUE_CSTRING(context, "reserve"), BT_VALUE_OBJECT(fn_ref));
 	bt_module_export(context, module, arr_reserve_sig, BT_VALUE_CSTRING(context, "reserve"), BT_VALUE_OBJECT(fn_ref));
+
+	bt_Type* arr_with_capacity_sig = bt_make_poly_signature_type(context, "with_capacity([T], number): [T]", bt_arr_with_capacity_type);
+	fn_ref = bt_make_native(context, module, arr_with_capacity_sig, bt_arr_with_capacity);
+	bt_type_add_field(context, array, arr_with_capacity_sig, BT_VALUE_CSTRING(context, "with_capacity"), BT_VALUE_OBJECT(fn_ref));
+	bt_module_export(context, module, arr_with_capacity_sig, BT_VALUE_CSTRING(context, "with_capacity"), BT_VALUE_OBJECT(fn_ref));
+
+	bt_Type* capacity_sig = bt_make_signature_type(context, context->types.number, &context->types.array, 1);
+	fn_ref = bt_make_native(context, module, capacity_sig, bt_arr_capacity);
+	bt_type_add_field(context, array, capacity_sig, BT_VALUE_CSTRING(context, "capacity"), BT_VALUE_OBJECT(fn_ref));
+	bt_module_export(context, module, capacity_sig, BT_VALUE_CSTRING(context, "capacity"), BT_VALUE_OBJECT(fn_ref));
+
+	bt_Type* arr_resize_sig = bt_make_poly_signature_type(context, "resize([T], number, T): [T]", bt_arr_resize_type);
+	fn_ref = bt_make_native(context, module, arr_resize_sig, bt_arr_resize);
+	bt_type_add_field(context, array, arr_resize_sig, BT_VALUE_CSTRING(context, "resize"), BT_VALUE_OBJECT(fn_ref));
+	bt_module_export(context, module, arr_resize_sig, BT_VALUE_CSTRING(context, "resize"), BT_VALUE_OBJECT(fn_ref));
+
+	bt_Type* shrink_to_fit_sig = bt_make_signature_type(context, context->types.number, &context->types.array, 1);
+	fn_ref = bt_make_native(context, module, shrink_to_fit_sig, bt_arr_shrink_to_fit);
+	bt_type_add_field(context, array, shrink_to_fit_sig, BT_VALUE_CSTRING(context, "shrink_to_fit"), BT_VALUE_OBJECT(fn_ref));
+	bt_module_export(context, module, shrink_to_fit_sig, BT_VALUE_CSTRING(context, "shrink_to_fit"), BT_VALUE_OBJECT(fn_ref));
 	
 	bt_Type* arr_concatenate_sig = bt_make_poly_signature_type(context, "concatenate([T], ..[T])", bt_arr_concatenate_type);
 	fn_ref = bt_make_native(context, module, arr_concatenate_sig, bt_arr_concatenate);
@@ -502,5 +1056,40 @@ void boltstd_open_arrays(bt_Context* context)
 	bt_type_add_field(context, array, arr_flaten_sig, BT_VALUE_CSTRING(context, "flatten"), BT_VALUE_OBJECT(fn_ref));
 	bt_module_export(context, module, arr_flaten_sig, BT_VALUE_CSTRING(context, "flatten"), BT_VALUE_OBJECT(fn_ref));
 	
+	bt_Type* arr_sum_sig = bt_make_poly_signature_type(context, "sum([number]): number", bt_arr_sum_type);
+	fn_ref = bt_make_native(context, module, arr_sum_sig, bt_arr_sum);
+	bt_type_add_field(context, array, arr_sum_sig, BT_VALUE_CSTRING(context, "sum"), BT_VALUE_OBJECT(fn_ref));
+	bt_module_export(context, module, arr_sum_sig, BT_VALUE_CSTRING(context, "sum"), BT_VALUE_OBJECT(fn_ref));
+
+	bt_Type* arr_dot_sig = bt_make_poly_signature_type(context, "dot([number], [number]): number", bt_arr_dot_type);
+	fn_ref = bt_make_native(context, module, arr_dot_sig, bt_arr_dot);
+	bt_type_add_field(context, array, arr_dot_sig, BT_VALUE_CSTRING(context, "dot"), BT_VALUE_OBJECT(fn_ref));
+	bt_module_export(context, module, arr_dot_sig, BT_VALUE_CSTRING(context, "dot"), BT_VALUE_OBJECT(fn_ref));
+
+	bt_Type* arr_min_max_sig = bt_make_poly_signature_type(context, "min_max([number]): [number]", bt_arr_min_max_type);
+	fn_ref = bt_make_native(context, module, arr_min_max_sig, bt_arr_min_max);
+	bt_type_add_field(context, array, arr_min_max_sig, BT_VALUE_CSTRING(context, "min_max"), BT_VALUE_OBJECT(fn_ref));
+	bt_module_export(context, module, arr_min_max_sig, BT_VALUE_CSTRING(context, "min_max"), BT_VALUE_OBJECT(fn_ref));
+
+	bt_Type* arr_scale_sig = bt_make_poly_signature_type(context, "scale([number], number): [number]", bt_arr_scale_type);
+	fn_ref = bt_make_native(context, module, arr_scale_sig, bt_arr_scale);
+	bt_type_add_field(context, array, arr_scale_sig, BT_VALUE_CSTRING(context, "scale"), BT_VALUE_OBJECT(fn_ref));
+	bt_module_export(context, module, arr_scale_sig, BT_VALUE_CSTRING(context, "scale"), BT_VALUE_OBJECT(fn_ref));
+
+	bt_Type* arr_add_arrays_sig = bt_make_poly_signature_type(context, "add_arrays([number], [number]): [number]", bt_arr_add_arrays_type);
+	fn_ref = bt_make_native(context, module, arr_add_arrays_sig, bt_arr_add_arrays);
+	bt_type_add_field(context, array, arr_add_arrays_sig, BT_VALUE_CSTRING(context, "add_arrays"), BT_VALUE_OBJECT(fn_ref));
+	bt_module_export(context, module, arr_add_arrays_sig, BT_VALUE_CSTRING(context, "add_arrays"), BT_VALUE_OBJECT(fn_ref));
+
+	bt_Type* arr_axpy_sig = bt_make_poly_signature_type(context, "axpy([number], number, [number]): [number]", bt_arr_axpy_type);
+	fn_ref = bt_make_native(context, module, arr_axpy_sig, bt_arr_axpy);
+	bt_type_add_field(context, array, arr_axpy_sig, BT_VALUE_CSTRING(context, "axpy"), BT_VALUE_OBJECT(fn_ref));
+	bt_module_export(context, module, arr_axpy_sig, BT_VALUE_CSTRING(context, "axpy"), BT_VALUE_OBJECT(fn_ref));
+
+	bt_Type* arr_fill_sig = bt_make_poly_signature_type(context, "fill([T], T): [T]", bt_arr_fill_type);
+	fn_ref = bt_make_native(context, module, arr_fill_sig, bt_arr_fill);
+	bt_type_add_field(context, array, arr_fill_sig, BT_VALUE_CSTRING(context, "fill"), BT_VALUE_OBJECT(fn_ref));
+	bt_module_export(context, module, arr_fill_sig, BT_VALUE_CSTRING(context, "fill"), BT_VALUE_OBJECT(fn_ref));
+
 	bt_register_module(context, BT_VALUE_CSTRING(context, "arrays"), module);
 }
\ No newline at end of file
@@ -0,0 +1,173 @@
+#include "boltstd_buffers.h"
+
+#include "../bt_embedding.h"
+
+#include <string.h>
+
+const char* bt_buffer_type_name = "Buffer";
+
+static void btbuffers_buffer_finalizer(bt_Context* ctx, bt_Userdata* userdata)
+{
+    bt_TypedBuffer* buffer = bt_userdata_get(userdata);
+    if (buffer->data) {
+        bt_gc_free(ctx, buffer->data, (size_t)buffer->length * bt_buffer_kind_size(buffer->kind));
+        buffer->data = 0;
+        buffer->length = 0;
+    }
+}
+
+bt_Userdata* boltstd_make_buffer(bt_Context* context, bt_BufferKind kind, uint32_t length)
+{
+    bt_TypedBuffer header;
+    header.data = 0;
+    header.length = 0;
+    header.kind = kind;
+
+    bt_Userdata* result = bt_make_userdata(context, boltstd_get_buffer_type(context), &header, sizeof(bt_TypedBuffer));
+    if (length == 0) return result;
+
+    // Allocating the storage may run a cycle, make sure the buffer survives it
+    bt_push_root(context, (bt_Object*)result);
+    size_t size = (size_t)length * bt_buffer_kind_size(kind);
+    uint8_t* data = bt_gc_alloc_owned(context, (bt_Object*)result, size);
+    memset(data, 0, size);
+    bt_pop_root(context);
+
+    bt_TypedBuffer* buffer = bt_userdata_get(result);
+    buffer->data = data;
+    buffer->length = length;
+
+    return result;
+}
+
+bt_Type* boltstd_get_buffer_type(bt_Context* context)
+{
+    // Other modules ask for the type while they're being opened, so the buffers module is opened first if it isn't yet
+    bt_Module* module = bt_find_registered_module(context, BT_VALUE_CSTRING(context, "buffers"));
+    if (!module) {
+        boltstd_open_buffers(context);
+        module = bt_find_registered_module(context, BT_VALUE_CSTRING(context, "buffers"));
+    }
+
+    return (bt_Type*)bt_object(bt_module_get_storage(module, BT_VALUE_CSTRING(context, bt_buffer_type_name)));
+}
+
+static void make_with_kind(bt_Context* ctx, bt_Thread* thread, bt_BufferKind kind)
+{
+    bt_number length = bt_get_number(bt_arg(thread, 0));
+    if (length < 0 || length > (bt_number)UINT32_MAX) {
+        bt_runtime_error(thread, "Buffer length out of range!", NULL);
+    }
+
+    bt_return(thread, bt_value((bt_Object*)boltstd_make_buffer(ctx, kind, (uint32_t)length)));
+}
+
+static void btbuffers_u8(bt_Context* ctx, bt_Thread* thread) { make_with_kind(ctx, thread, BT_BUFFER_U8); }
+static void btbuffers_i32(bt_Context* ctx, bt_Thread* thread) { make_with_kind(ctx, thread, BT_BUFFER_I32); }
+static void btbuffers_f32(bt_Context* ctx, bt_Thread* thread) { make_with_kind(ctx, thread, BT_BUFFER_F32); }
+static void btbuffers_f64(bt_Context* ctx, bt_Thread* thread) { make_with_kind(ctx, thread, BT_BUFFER_F64); }
+
+static void btbuffers_from_string(bt_Context* ctx, bt_Thread* thread)
+{
+    bt_String* source = (bt_String*)bt_object(bt_arg(thread, 0));
+    uint32_t length = bt_string_length(source);
+
+    bt_Userdata* result = boltstd_make_buffer(ctx, BT_BUFFER_U8, length);
+    bt_TypedBuffer* buffer = bt_userdata_get(result);
+    if (length) memcpy(buffer->data, bt_string_get(source), length);
+
+    bt_return(thread, bt_value((bt_Object*)result));
+}
+
+static void btbuffers_length(bt_Context* ctx, bt_Thread* thread)
+{
+    bt_TypedBuffer* buffer = bt_userdata_get((bt_Userdata*)bt_object(bt_arg(thread, 0)));
+    bt_return(thread, bt_make_number((bt_number)buffer->length));
+}
+
+static void btbuffers_byte_size(bt_Context* ctx, bt_Thread* thread)
+{
+    bt_TypedBuffer* buffer = bt_userdata_get((bt_Userdata*)bt_object(bt_arg(thread, 0)));
+    bt_return(thread, bt_make_number((bt_number)((size_t)buffer->length * bt_buffer_kind_size(buffer->kind))));
+}
+
+static void btbuffers_fill(bt_Context* ctx, bt_Thread* thread)
+{
+    bt_TypedBuffer* buffer = bt_userdata_get((bt_Userdata*)bt_object(bt_arg(thread, 0)));
+    bt_Value value = bt_arg(thread, 1);
+    if (buffer->length == 0) return;
+
+    // Convert once through the regular store, then replicate the element bytes
+    bt_typed_buffer_set(thread, buffer, 0, value);
+
+    size_t element_size = bt_buffer_kind_size(buffer->kind);
+    size_t total = (size_t)buffer->length * element_size;
+    size_t filled = element_size;
+    while (filled < total) {
+        size_t step = filled < total - filled ? filled : total - filled;
+        memcpy(buffer->data + filled, buffer->data, step);
+        filled += step;
+    }
+}
+
+static void btbuffers_to_string(bt_Context* ctx, bt_Thread* thread)
+{
+    bt_TypedBuffer* buffer = bt_userdata_get((bt_Userdata*)bt_object(bt_arg(thread, 0)));
+    size_t size = (size_t)buffer->length * bt_buffer_kind_size(buffer->kind);
+    if (size > BT_STRING_MAX_LEN) bt_runtime_error(thread, "Buffer too large to convert to string!", NULL);
+
+    bt_return(thread, bt_value((bt_Object*)bt_make_string_len(ctx, (const char*)buffer->data, (uint32_t)size)));
+}
+
+static void btbuffers_to_array(bt_Context* ctx, bt_Thread* thread)
+{
+    bt_TypedBuffer* buffer = bt_userdata_get((bt_Userdata*)bt_object(bt_arg(thread, 0)));
+
+    bt_Array* result = bt_make_array(ctx, buffer->length);
+    bt_push_root(ctx, (bt_Object*)result);
+    for (uint32_t i = 0; i < buffer->length; i++) {
+        bt_array_push(ctx, result, bt_typed_buffer_get(thread, buffer, i));
+    }
+    bt_pop_root(ctx);
+
+    bt_return(thread, bt_value((bt_Object*)result));
+}
+
+static void export_method(bt_Context* context, bt_Module* module, bt_Type* buffer_type, const char* name, bt_NativeProc proc, bt_Type* ret, bt_Type** args, uint8_t argc)
+{
+    bt_Type* sig = bt_make_signature_type(context, ret, args, argc);
+    bt_NativeFn* ref = bt_make_native(context, module, sig, proc);
+    bt_type_add_field(context, buffer_type, sig, BT_VALUE_CSTRING(context, name), BT_VALUE_OBJECT(ref));
+    bt_module_export(context, module, sig, BT_VALUE_CSTRING(context, name), BT_VALUE_OBJECT(ref));
+}
+
+void boltstd_open_buffers(bt_Context* context)
+{
+    if (bt_find_registered_module(context, BT_VALUE_CSTRING(context, "buffers"))) return;
+
+    bt_Module* module = bt_make_module(context);
+
+    bt_Type* buffer_type = bt_make_userdata_type(context, bt_buffer_type_name);
+    bt_userdata_type_set_finalizer(buffer_type, btbuffers_buffer_finalizer);
+    bt_userdata_type_set_buffer(buffer_type);
+    bt_module_export(context, module, bt_type_type(context), BT_VALUE_CSTRING(context, bt_buffer_type_name), BT_VALUE_OBJECT(buffer_type));
+    bt_module_set_storage(module, BT_VALUE_CSTRING(context, bt_buffer_type_name), bt_value((bt_Object*)buffer_type));
+
+    bt_Type* string = bt_type_string(context);
+    bt_Type* number = bt_type_number(context);
+
+    bt_module_export_native(context, module, "u8", btbuffers_u8, buffer_type, &number, 1);
+    bt_module_export_native(context, module, "i32", btbuffers_i32, buffer_type, &number, 1);
+    bt_module_export_native(context, module, "f32", btbuffers_f32, buffer_type, &number, 1);
+    bt_module_export_native(context, module, "f64", btbuffers_f64, buffer_type, &number, 1);
+    bt_module_export_native(context, module, "from_string", btbuffers_from_string, buffer_type, &string, 1);
+
+    bt_Type* fill_args[] = { buffer_type, number };
+    export_method(context, module, buffer_type, "length", btbuffers_length, number, &buffer_type, 1);
+    export_method(context, module, buffer_type, "byte_size", btbuffers_byte_size, number, &buffer_type, 1);
+    export_method(context, module, buffer_type, "fill", btbuffers_fill, NULL, fill_args, 2);
+    export_method(context, module, buffer_type, "to_string", btbuffers_to_string, string, &buffer_type, 1);
+    export_method(context, module, buffer_type, "to_array", btbuffers_to_array, bt_make_array_type(context, number), &buffer_type, 1);
+
+    bt_register_module(context, BT_VALUE_CSTRING(context, "buffers"), module);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#if __cplusplus
+extern "C" {
+#endif
+
+#include "../bolt.h"
+#include "../bt_userdata.h"
+
+extern const char* bt_buffer_type_name;
+
+BOLT_API void boltstd_open_buffers(bt_Context* context);
+BOLT_API bt_Type* boltstd_get_buffer_type(bt_Context* context);
+/** Makes a zero-filled buffer of `length` elements of `kind`, its storage is reachable through bt_userdata_get() for sharing with host code */
+BOLT_API bt_Userdata* boltstd_make_buffer(bt_Context* context, bt_BufferKind kind, uint32_t length);
+
+#if __cplusplus
+}
+#endif
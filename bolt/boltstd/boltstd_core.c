@@ -2,6 +2,7 @@
 
 #include "../bt_embedding.h"
 
+#include <ctype.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
@@ -40,7 +41,7 @@ static void bt_cout(bt_Context* ctx, bt_Thread* thread)
 	for (uint8_t i = 0; i < argc; ++i) {
 		bt_Value arg = bt_arg(thread, i);
 		bt_String* as_str = bt_to_string(ctx, arg);
-		ctx->write(ctx, BT_STRING_STR(as_str));
+		ctx->write(ctx, bt_string_cstr(ctx, as_str));
 
 		if (i < argc - 1) ctx->write(ctx, " ");
 	}
@@ -83,9 +84,20 @@ static void bt_tonumber(bt_Context* ctx, bt_Thread* thread)
 	bt_Value arg = bt_arg(thread, 0);
 	bt_String* as_str = (bt_String*)BT_AS_OBJECT(arg);
 
+	const char* start = BT_STRING_STR(as_str);
+	uint32_t offset = 0;
+	while (offset < as_str->len && isspace((unsigned char)start[offset])) offset++;
+
+	bt_number n;
+	if (bt_parse_number(start + offset, as_str->len - offset, &n)) {
+		bt_return(thread, BT_VALUE_NUMBER(n));
+		return;
+	}
+
+	// Hexadecimal, inf and nan are rare enough to leave to the C library
 	char* end;
-	char* start = BT_STRING_STR(as_str);
-	double n = strtod(start, &end);
+	start = bt_string_cstr(ctx, as_str);
+	n = strtod(start, &end);
 
 	if (start == end) {
 		bt_return(thread, BT_VALUE_NULL);
@@ -98,7 +110,7 @@ static void bt_tonumber(bt_Context* ctx, bt_Thread* thread)
 static void bt_throw(bt_Context* ctx, bt_Thread* thread)
 {
 	bt_String* message = bt_to_string(ctx, bt_arg(thread, 0));
-	bt_runtime_error(thread, BT_STRING_STR(message), NULL);
+	bt_runtime_error(thread, bt_string_cstr(ctx, message), NULL);
 }
 
 static void bt_error(bt_Context* ctx, bt_Thread* thread)
@@ -155,10 +167,15 @@ static void bt_protect(bt_Context* ctx, bt_Thread* thread)
 		bt_Module* module = bt_get_module(thread);
 		bt_Type* error_type = (bt_Type*)bt_object(bt_module_get_storage(module, BT_VALUE_CSTRING(ctx, bt_error_type_name)));
 	
+		// The failed thread is no longer traced, so its error has to be kept alive while the result is built
+		bt_push_root(ctx, (bt_Object*)new_thread->last_error);
 		bt_Table* result = bt_make_table(ctx, 1);
+		bt_push_root(ctx, (bt_Object*)result);
 		result->prototype = bt_type_get_proto(ctx, error_type);
 
 		bt_table_set(ctx, result, BT_VALUE_CSTRING(ctx, bt_error_what_key_name), BT_VALUE_OBJECT(new_thread->last_error));
+		bt_pop_root(ctx);
+		bt_pop_root(ctx);
 
 		bt_return(thread, BT_VALUE_OBJECT(result));
 	}
@@ -220,7 +237,7 @@ static void bt_assert(bt_Context* ctx, bt_Thread* thread)
 			error_message = bt_string_concat(ctx, new_error, error_message);
 		}
 
-		bt_runtime_error(thread, BT_STRING_STR(error_message), NULL);
+		bt_runtime_error(thread, bt_string_cstr(ctx, error_message), NULL);
 	}
 	else {
 		bt_return(thread, result);
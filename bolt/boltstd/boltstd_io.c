@@ -3,6 +3,7 @@
 #include "../bt_embedding.h"
 
 #include "boltstd_core.h"
+#include "boltstd_buffers.h"
 
 #include <stdlib.h>
 #include <stdio.h>
@@ -61,8 +62,8 @@ static void btio_open(bt_Context* ctx, bt_Thread* thread)
 {
 	bt_String* path = (bt_String*)BT_AS_OBJECT(bt_arg(thread, 0));
 	bt_String* mode = (bt_String*)BT_AS_OBJECT(bt_arg(thread, 1));
-	const char* cpath = BT_STRING_STR(path);
-	const char* cmode = BT_STRING_STR(mode);
+	const char* cpath = bt_string_cstr(ctx, path);
+	const char* cmode = bt_string_cstr(ctx, mode);
 	FILE* file = fopen(cpath, cmode);
 
 	if (file) {
@@ -236,6 +237,50 @@ static void btio_write(bt_Context* ctx, bt_Thread* thread)
 	}
 }
 
+static void btio_read_into(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Userdata* file = (bt_Userdata*)BT_AS_OBJECT(bt_arg(thread, 0));
+	bt_TypedBuffer* buffer = bt_userdata_get((bt_Userdata*)BT_AS_OBJECT(bt_arg(thread, 1)));
+	btio_FileState* state = bt_userdata_get(file);
+
+	if (state->is_open) {
+		size_t size = (size_t)buffer->length * bt_buffer_kind_size(buffer->kind);
+		size_t n_read = size ? fread(buffer->data, 1, size, state->handle) : 0;
+
+		if (n_read != size && !feof(state->handle)) {
+			bt_return(thread, boltstd_make_error(ctx, error_to_desc(errno)));
+		}
+		else {
+			bt_return(thread, BT_VALUE_NUMBER(n_read));
+		}
+	}
+	else {
+		bt_return(thread, boltstd_make_error(ctx, close_error_reason));
+	}
+}
+
+static void btio_write_from(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Userdata* file = (bt_Userdata*)BT_AS_OBJECT(bt_arg(thread, 0));
+	bt_TypedBuffer* buffer = bt_userdata_get((bt_Userdata*)BT_AS_OBJECT(bt_arg(thread, 1)));
+	btio_FileState* state = bt_userdata_get(file);
+
+	if (state->is_open) {
+		size_t size = (size_t)buffer->length * bt_buffer_kind_size(buffer->kind);
+		size_t n_written = size ? fwrite(buffer->data, 1, size, state->handle) : 0;
+
+		if (n_written != size) {
+			bt_return(thread, boltstd_make_error(ctx, error_to_desc(errno)));
+		}
+		else {
+			bt_return(thread, BT_VALUE_NULL);
+		}
+	}
+	else {
+		bt_return(thread, boltstd_make_error(ctx, close_error_reason));
+	}
+}
+
 static void btio_iseof(bt_Context* ctx, bt_Thread* thread)
 {
 	bt_Userdata* file = (bt_Userdata*)BT_AS_OBJECT(bt_arg(thread, 0));
@@ -254,7 +299,7 @@ static void btio_delete(bt_Context* ctx, bt_Thread* thread)
 {
 	bt_String* path = (bt_String*)BT_AS_OBJECT(bt_arg(thread, 0));
 
-	int32_t result = remove(BT_STRING_STR(path));
+	int32_t result = remove(bt_string_cstr(ctx, path));
 
 	if (result != 0) {
 		bt_return(thread, boltstd_make_error(ctx, error_to_desc(errno)));
@@ -309,6 +354,11 @@ void boltstd_open_io(bt_Context* context)
 	bt_Type* write_args[] = { io_file_type, string };
 	bt_module_export_native(context, module, "write", btio_write, optional_error, write_args, 2);
 
+	bt_Type* buffer_type = boltstd_get_buffer_type(context);
+	bt_Type* buffer_args[] = { io_file_type, buffer_type };
+	bt_module_export_native(context, module, "read_into", btio_read_into, number_or_error, buffer_args, 2);
+	bt_module_export_native(context, module, "write_from", btio_write_from, optional_error, buffer_args, 2);
+
 	bt_module_export_native(context, module, "is_eof", btio_iseof, boolean, &io_file_type, 1);
 	bt_module_export_native(context, module, "delete", btio_delete, optional_error, &string, 1);
 
@@ -0,0 +1,282 @@
+#include "boltstd_iter.h"
+
+#include "../bt_embedding.h"
+
+// Every stage takes either an array or an iterator function (`fn: T?`) as its source. Stages are native closures that
+// pull one element at a time from the stage before them, so a whole pipeline runs in a single pass without
+// building any intermediate arrays. Array sources are walked directly, tracking their position in an upvalue.
+
+// The native functions each stage closes over live in module storage, so every context looks up its own
+static const char* map_iter_name = "map_iter";
+static const char* filter_iter_name = "filter_iter";
+static const char* take_iter_name = "take_iter";
+
+static bt_Value stage_iter_fn(bt_Context* ctx, bt_Thread* thread, const char* name)
+{
+	return bt_module_get_storage(bt_get_module(thread), BT_VALUE_CSTRING(ctx, name));
+}
+
+static bt_Type* source_element_type(bt_Context* ctx, bt_Type* source)
+{
+	source = bt_type_dealias(source);
+
+	if (source->category == BT_TYPE_CATEGORY_ARRAY) return source->as.array.inner;
+
+	if (source->category == BT_TYPE_CATEGORY_SIGNATURE) {
+		if (source->as.fn.args.length != 0 || source->as.fn.is_vararg) return NULL;
+		if (!source->as.fn.return_type || !bt_type_is_optional(source->as.fn.return_type)) return NULL;
+		return bt_type_remove_nullable(ctx, source->as.fn.return_type);
+	}
+
+	return NULL;
+}
+
+static bt_Type* make_iterator_type(bt_Context* ctx, bt_Type* element)
+{
+	return bt_make_signature_type(ctx, bt_type_make_nullable(ctx, element), NULL, 0);
+}
+
+static bt_Value next_from(bt_Thread* thread, bt_Value source, uint32_t* position)
+{
+	bt_Object* obj = BT_AS_OBJECT(source);
+	if (BT_OBJECT_GET_TYPE(obj) == BT_OBJECT_TYPE_ARRAY) {
+		bt_Array* arr = (bt_Array*)obj;
+		BT_ARRAY_SYNC(arr);
+		if (*position >= arr->length) return BT_VALUE_NULL;
+		return arr->items[(*position)++];
+	}
+
+	bt_push(thread, source);
+	bt_call(thread, 0);
+	return bt_pop(thread);
+}
+
+// Pulls the next element for a stage closure, whose first two upvalues are always the source and its position
+static bt_Value next_from_upvals(bt_Thread* thread)
+{
+	bt_Value source = bt_getup(thread, 0);
+	uint32_t position = (uint32_t)BT_AS_NUMBER(bt_getup(thread, 1));
+	bt_Value result = next_from(thread, source, &position);
+	bt_setup(thread, 1, BT_VALUE_NUMBER(position));
+	return result;
+}
+
+static bt_Type* bt_iter_map_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
+{
+	if (argc != 2) return NULL;
+	bt_Type* element = source_element_type(ctx, args[0]);
+	if (!element) return NULL;
+
+	bt_Type* applicator = bt_type_dealias(args[1]);
+	if (applicator->category != BT_TYPE_CATEGORY_SIGNATURE) return NULL;
+	if (applicator->as.fn.args.length != 1) return NULL;
+	if (!applicator->as.fn.args.elements[0]->satisfier(applicator->as.fn.args.elements[0], element)) return NULL;
+
+	// A null result would be indistinguishable from the end of the iterator
+	bt_Type* mapped = applicator->as.fn.return_type;
+	if (!mapped || bt_type_is_optional(mapped)) return NULL;
+
+	return bt_make_signature_type(ctx, make_iterator_type(ctx, mapped), args, 2);
+}
+
+static void bt_iter_map(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Value source = bt_arg(thread, 0);
+	bt_Value stage_arg = bt_arg(thread, 1);
+
+	bt_push(thread, stage_iter_fn(ctx, thread, map_iter_name));
+	bt_push(thread, source);
+	bt_push(thread, BT_VALUE_NUMBER(0));
+	bt_push(thread, stage_arg);
+
+	bt_return(thread, bt_make_closure(thread, 3));
+}
+
+static void bt_iter_map_iter(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Value next = next_from_upvals(thread);
+	if (next == BT_VALUE_NULL) {
+		bt_return(thread, BT_VALUE_NULL);
+		return;
+	}
+
+	bt_push(thread, bt_getup(thread, 2));
+	bt_push(thread, next);
+	bt_call(thread, 1);
+
+	bt_return(thread, bt_pop(thread));
+}
+
+static bt_Type* bt_iter_filter_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
+{
+	if (argc != 2) return NULL;
+	bt_Type* element = source_element_type(ctx, args[0]);
+	if (!element) return NULL;
+
+	bt_Type* filter = bt_type_dealias(args[1]);
+	if (filter->category != BT_TYPE_CATEGORY_SIGNATURE) return NULL;
+	if (filter->as.fn.return_type != ctx->types.boolean) return NULL;
+	if (filter->as.fn.args.length != 1) return NULL;
+	if (!filter->as.fn.args.elements[0]->satisfier(filter->as.fn.args.elements[0], element)) return NULL;
+
+	return bt_make_signature_type(ctx, make_iterator_type(ctx, element), args, 2);
+}
+
+static void bt_iter_filter(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Value source = bt_arg(thread, 0);
+	bt_Value stage_arg = bt_arg(thread, 1);
+
+	bt_push(thread, stage_iter_fn(ctx, thread, filter_iter_name));
+	bt_push(thread, source);
+	bt_push(thread, BT_VALUE_NUMBER(0));
+	bt_push(thread, stage_arg);
+
+	bt_return(thread, bt_make_closure(thread, 3));
+}
+
+static void bt_iter_filter_iter(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Value next;
+	while ((next = next_from_upvals(thread)) != BT_VALUE_NULL) {
+		bt_push(thread, bt_getup(thread, 2));
+		bt_push(thread, next);
+		bt_call(thread, 1);
+
+		if (bt_pop(thread) == BT_VALUE_TRUE) break;
+	}
+
+	bt_return(thread, next);
+}
+
+static bt_Type* bt_iter_take_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
+{
+	if (argc != 2) return NULL;
+	bt_Type* element = source_element_type(ctx, args[0]);
+	if (!element) return NULL;
+	if (bt_type_dealias(args[1]) != ctx->types.number) return NULL;
+
+	return bt_make_signature_type(ctx, make_iterator_type(ctx, element), args, 2);
+}
+
+static void bt_iter_take(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Value source = bt_arg(thread, 0);
+	bt_Value stage_arg = bt_arg(thread, 1);
+
+	bt_push(thread, stage_iter_fn(ctx, thread, take_iter_name));
+	bt_push(thread, source);
+	bt_push(thread, BT_VALUE_NUMBER(0));
+	bt_push(thread, stage_arg);
+
+	bt_return(thread, bt_make_closure(thread, 3));
+}
+
+static void bt_iter_take_iter(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_number remaining = BT_AS_NUMBER(bt_getup(thread, 2));
+	if (remaining < 1) {
+		bt_return(thread, BT_VALUE_NULL);
+		return;
+	}
+
+	bt_setup(thread, 2, BT_VALUE_NUMBER(remaining - 1));
+	bt_return(thread, next_from_upvals(thread));
+}
+
+static bt_Type* bt_iter_reduce_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
+{
+	if (argc != 3) return NULL;
+	bt_Type* element = source_element_type(ctx, args[0]);
+	if (!element) return NULL;
+
+	bt_Type* reducer = bt_type_dealias(args[2]);
+	if (reducer->category != BT_TYPE_CATEGORY_SIGNATURE) return NULL;
+	if (reducer->as.fn.args.length != 2 || !reducer->as.fn.return_type) return NULL;
+
+	bt_Type* accumulator = reducer->as.fn.args.elements[0];
+	if (!accumulator->satisfier(accumulator, args[1])) return NULL;
+	if (!accumulator->satisfier(accumulator, reducer->as.fn.return_type)) return NULL;
+	if (!reducer->as.fn.args.elements[1]->satisfier(reducer->as.fn.args.elements[1], element)) return NULL;
+
+	return bt_make_signature_type(ctx, accumulator, args, 3);
+}
+
+static void bt_iter_reduce(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Value source = bt_arg(thread, 0);
+	bt_Value accumulator = bt_arg(thread, 1);
+	bt_Value reducer = bt_arg(thread, 2);
+
+	uint32_t position = 0;
+	for (;;) {
+		// The source may run a collection while the accumulator is only held here
+		bt_bool rooted = BT_IS_OBJECT(accumulator);
+		if (rooted) bt_push_root(ctx, BT_AS_OBJECT(accumulator));
+		bt_Value next = next_from(thread, source, &position);
+		if (rooted) bt_pop_root(ctx);
+
+		if (next == BT_VALUE_NULL) break;
+
+		bt_push(thread, reducer);
+		bt_push(thread, accumulator);
+		bt_push(thread, next);
+		bt_call(thread, 2);
+
+		accumulator = bt_pop(thread);
+	}
+
+	bt_return(thread, accumulator);
+}
+
+static bt_Type* bt_iter_collect_type(bt_Context* ctx, bt_Type** args, uint8_t argc)
+{
+	if (argc != 1) return NULL;
+	bt_Type* element = source_element_type(ctx, args[0]);
+	if (!element) return NULL;
+
+	return bt_make_signature_type(ctx, bt_make_array_type(ctx, element), args, 1);
+}
+
+static void bt_iter_collect(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Value source = bt_arg(thread, 0);
+
+	bt_Array* result = bt_make_array(ctx, 0);
+	bt_push_root(ctx, (bt_Object*)result);
+
+	uint32_t position = 0;
+	bt_Value next;
+	while ((next = next_from(thread, source, &position)) != BT_VALUE_NULL) {
+		bt_array_push(ctx, result, next);
+	}
+
+	bt_return(thread, BT_VALUE_OBJECT(result));
+	bt_pop_root(ctx);
+}
+
+void boltstd_open_iter(bt_Context* context)
+{
+	bt_Module* module = bt_make_module(context);
+
+	bt_module_set_storage(module, BT_VALUE_CSTRING(context, map_iter_name), BT_VALUE_OBJECT(bt_make_native(context, module, NULL, bt_iter_map_iter)));
+	bt_module_set_storage(module, BT_VALUE_CSTRING(context, filter_iter_name), BT_VALUE_OBJECT(bt_make_native(context, module, NULL, bt_iter_filter_iter)));
+	bt_module_set_storage(module, BT_VALUE_CSTRING(context, take_iter_name), BT_VALUE_OBJECT(bt_make_native(context, module, NULL, bt_iter_take_iter)));
+
+	bt_Type* map_sig = bt_make_poly_signature_type(context, "map([T] | fn: T?, fn(T): R): fn: R?", bt_iter_map_type);
+	bt_module_export(context, module, map_sig, BT_VALUE_CSTRING(context, "map"), BT_VALUE_OBJECT(bt_make_native(context, module, map_sig, bt_iter_map)));
+
+	bt_Type* filter_sig = bt_make_poly_signature_type(context, "filter([T] | fn: T?, fn(T): bool): fn: T?", bt_iter_filter_type);
+	bt_module_export(context, module, filter_sig, BT_VALUE_CSTRING(context, "filter"), BT_VALUE_OBJECT(bt_make_native(context, module, filter_sig, bt_iter_filter)));
+
+	bt_Type* take_sig = bt_make_poly_signature_type(context, "take([T] | fn: T?, number): fn: T?", bt_iter_take_type);
+	bt_module_export(context, module, take_sig, BT_VALUE_CSTRING(context, "take"), BT_VALUE_OBJECT(bt_make_native(context, module, take_sig, bt_iter_take)));
+
+	bt_Type* reduce_sig = bt_make_poly_signature_type(context, "reduce([T] | fn: T?, A, fn(A, T): A): A", bt_iter_reduce_type);
+	bt_module_export(context, module, reduce_sig, BT_VALUE_CSTRING(context, "reduce"), BT_VALUE_OBJECT(bt_make_native(context, module, reduce_sig, bt_iter_reduce)));
+
+	bt_Type* collect_sig = bt_make_poly_signature_type(context, "collect([T] | fn: T?): [T]", bt_iter_collect_type);
+	bt_module_export(context, module, collect_sig, BT_VALUE_CSTRING(context, "collect"), BT_VALUE_OBJECT(bt_make_native(context, module, collect_sig, bt_iter_collect)));
+
+	bt_register_module(context, BT_VALUE_CSTRING(context, "iter"), module);
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#if __cplusplus
+extern "C" {
+#endif
+
+#include "../bolt.h"
+
+void BOLT_API boltstd_open_iter(bt_Context* context);
+
+#if __cplusplus
+}
+#endif
\ No newline at end of file
@@ -10,6 +10,14 @@
 static const char* annotation_type_name = "Annotation";
 static const char* annotation_name_key_name = "name";
 static const char* annotation_args_key_name = "args";
+static const char* gc_stats_type_name = "GCStats";
+
+static const char* gc_stats_number_fields[] = {
+	"cycles", "last_pause", "max_pause", "total_pause",
+	"last_bytes_freed", "last_objects_freed", "total_bytes_freed", "total_objects_freed",
+	"total_bytes_allocated", "total_objects_allocated",
+};
+#define GC_STATS_NUMBER_FIELDS (sizeof(gc_stats_number_fields) / sizeof(gc_stats_number_fields[0]))
 
 static void btstd_gc(bt_Context* ctx, bt_Thread* thread)
 {
@@ -27,6 +35,55 @@ static void btstd_nextcycle(bt_Context* ctx, bt_Thread* thread)
 	bt_return(thread, bt_make_number((bt_number)ctx->gc.next_cycle));
 }
 
+static void btstd_gc_stats(bt_Context* ctx, bt_Thread* thread)
+{
+	const bt_GCStats* stats = bt_gc_get_stats(ctx);
+
+	bt_Module* module = bt_get_module(thread);
+	bt_Type* stats_type = (bt_Type*)bt_object(bt_module_get_storage(module, BT_VALUE_CSTRING(ctx, gc_stats_type_name)));
+	bt_Table* result = bt_make_table(ctx, GC_STATS_NUMBER_FIELDS + 3);
+	result->prototype = bt_type_get_proto(ctx, stats_type);
+	bt_return(thread, BT_VALUE_OBJECT(result));
+
+	// Fields are set in layout order, so that slot prediction on the sealed type stays valid
+
+	// Pause times are exposed in microseconds, matching `core.time()`
+	bt_number numbers[GC_STATS_NUMBER_FIELDS] = {
+		(bt_number)stats->cycles, stats->last_pause / 1000.0, stats->max_pause / 1000.0, stats->total_pause / 1000.0,
+		(bt_number)stats->last_bytes_freed, (bt_number)stats->last_objects_freed, (bt_number)stats->total_bytes_freed, (bt_number)stats->total_objects_freed,
+		(bt_number)stats->total_bytes_allocated, (bt_number)stats->total_objects_allocated,
+	};
+
+	for (uint32_t i = 0; i < GC_STATS_NUMBER_FIELDS; ++i) {
+		bt_table_set(ctx, result, BT_VALUE_CSTRING(ctx, gc_stats_number_fields[i]), bt_make_number(numbers[i]));
+	}
+
+	bt_Array* histogram = bt_make_array(ctx, BT_GC_PAUSE_BUCKETS);
+	bt_table_set(ctx, result, BT_VALUE_CSTRING(ctx, "pause_histogram"), BT_VALUE_OBJECT(histogram));
+	for (uint32_t i = 0; i < BT_GC_PAUSE_BUCKETS; ++i) {
+		bt_array_push(ctx, histogram, bt_make_number(stats->pause_histogram[i]));
+	}
+
+	bt_Table* live_objects = bt_make_table(ctx, BT_GC_OBJECT_TYPES);
+	bt_table_set(ctx, result, BT_VALUE_CSTRING(ctx, "live_objects"), BT_VALUE_OBJECT(live_objects));
+	bt_Table* live_bytes = bt_make_table(ctx, BT_GC_OBJECT_TYPES);
+	bt_table_set(ctx, result, BT_VALUE_CSTRING(ctx, "live_bytes"), BT_VALUE_OBJECT(live_bytes));
+
+	for (uint32_t i = BT_OBJECT_TYPE_TYPE; i < BT_GC_OBJECT_TYPES; ++i) {
+		bt_Value name = BT_VALUE_CSTRING(ctx, bt_gc_object_type_name((bt_ObjectType)i));
+		bt_table_set(ctx, live_objects, name, bt_make_number((bt_number)stats->live_objects[i]));
+		bt_table_set(ctx, live_bytes, name, bt_make_number((bt_number)stats->live_bytes[i]));
+	}
+}
+
+static void btstd_gc_pause_percentile(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_number percentile = BT_AS_NUMBER(bt_arg(thread, 0));
+	if (percentile < 0) percentile = 0;
+	
+	bt_return(thread, bt_make_number(bt_gc_get_pause_percentile(ctx, (uint32_t)percentile) / 1000.0));
+}
+
 static void btstd_grey(bt_Context* ctx, bt_Thread* thread)
 {
 	if (!BT_IS_OBJECT(bt_arg(thread, 0))) return;
@@ -103,7 +160,7 @@ static void btstd_add_module_path(bt_Context* ctx, bt_Thread* thread)
 {
 	bt_String* pathspec = (bt_String*)BT_AS_OBJECT(bt_arg(thread, 0));
 
-	bt_append_module_path(ctx, BT_STRING_STR(pathspec));
+	bt_append_module_path(ctx, bt_string_cstr(ctx, pathspec));
 }
 
 static void btstd_get_union_size(bt_Context* ctx, bt_Thread* thread)
@@ -141,6 +198,27 @@ static void btstd_dump(bt_Context* ctx, bt_Thread* thread)
 	bt_return(thread, BT_VALUE_OBJECT(bt_debug_dump_fn(ctx, arg)));
 }
 
+static void write_snapshot_file(void* file, const char* data, size_t length)
+{
+	fwrite(data, 1, length, (FILE*)file);
+}
+
+static void btstd_heap_snapshot(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_String* path = (bt_String*)BT_AS_OBJECT(bt_arg(thread, 0));
+
+	FILE* file = fopen(bt_string_cstr(ctx, path), "wb");
+	if (!file) {
+		bt_return(thread, boltstd_make_error(ctx, "Failed to open heap snapshot file!"));
+		return;
+	}
+
+	bt_heap_snapshot(ctx, write_snapshot_file, file);
+	fclose(file);
+
+	bt_return(thread, BT_VALUE_NULL);
+}
+
 static void populate_annotation_array(bt_Context* ctx, bt_Type* anno_type, bt_Annotation* anno, bt_Array* array) {
 	while (anno) {
 		bt_Table* bt_anno = bt_make_table_from_proto(ctx, anno_type);
@@ -233,7 +311,7 @@ static void btstd_try_compile(bt_Context* ctx, bt_Thread* thread)
 	btstd_safe_error_ctx = ctx;
 	ctx->on_error = btstd_safe_error;
 	
-	bt_Module* mod = bt_compile_module(ctx, BT_STRING_STR(source), BT_STRING_STR(module_name));
+	bt_Module* mod = bt_compile_module(ctx, bt_string_cstr(ctx, source), bt_string_cstr(ctx, module_name));
 
 	btstd_safe_error_ctx = NULL;
 	ctx->on_error = old_onerror;
@@ -242,7 +320,7 @@ static void btstd_try_compile(bt_Context* ctx, bt_Thread* thread)
 		bt_return(thread, bt_value((bt_Object*)mod));
 	} else {
 		bt_remove_ref(ctx, (bt_Object*)btstd_safe_error_string);
-		bt_return(thread, boltstd_make_error(ctx, BT_STRING_STR(btstd_safe_error_string)));
+		bt_return(thread, boltstd_make_error(ctx, bt_string_cstr(ctx, btstd_safe_error_string)));
 		btstd_safe_error_string = NULL;
 	}
 }
@@ -272,11 +350,21 @@ void boltstd_open_meta(bt_Context* context)
 	bt_tableshape_add_layout(context, annotation_type, bt_type_string(context), BT_VALUE_CSTRING(context, annotation_name_key_name), bt_type_string(context));
 	bt_tableshape_add_layout(context, annotation_type, bt_type_string(context), BT_VALUE_CSTRING(context, annotation_args_key_name), bt_make_array_type(context, any));
 	bt_module_set_storage(module, BT_VALUE_CSTRING(context, annotation_type_name), bt_value((bt_Object*)annotation_type));
+
+	bt_Type* stats_type = bt_make_tableshape_type(context, gc_stats_type_name, BT_TRUE);
+	for (uint32_t i = 0; i < GC_STATS_NUMBER_FIELDS; ++i) {
+		bt_tableshape_add_layout(context, stats_type, string, BT_VALUE_CSTRING(context, gc_stats_number_fields[i]), number);
+	}
+	bt_tableshape_add_layout(context, stats_type, string, BT_VALUE_CSTRING(context, "pause_histogram"), bt_make_array_type(context, number));
+	bt_tableshape_add_layout(context, stats_type, string, BT_VALUE_CSTRING(context, "live_objects"), bt_make_map(context, string, number));
+	bt_tableshape_add_layout(context, stats_type, string, BT_VALUE_CSTRING(context, "live_bytes"), bt_make_map(context, string, number));
+	bt_module_set_storage(module, BT_VALUE_CSTRING(context, gc_stats_type_name), bt_value((bt_Object*)stats_type));
 	
 	bt_module_export(context, module, number, BT_VALUE_CSTRING(context, "stack_size"),     bt_make_number(BT_STACK_SIZE));
 	bt_module_export(context, module, number, BT_VALUE_CSTRING(context, "callstack_size"), bt_make_number(BT_CALLSTACK_SIZE));
 	bt_module_export(context, module, string, BT_VALUE_CSTRING(context, "version"),        bt_value((bt_Object*)bt_make_string(context, BOLT_VERSION)));
 	bt_module_export(context, module, type,   BT_VALUE_CSTRING(context, "Annotation"),     bt_value((bt_Object*)annotation_type));
+	bt_module_export(context, module, type,   BT_VALUE_CSTRING(context, "GCStats"),        bt_value((bt_Object*)stats_type));
 	
 	bt_Type* findtype_ret = bt_type_make_nullable(context, type);
 	bt_Type* findmodule_ret = bt_type_make_nullable(context, table);
@@ -284,6 +372,8 @@ void boltstd_open_meta(bt_Context* context)
 
 	bt_Type* trycompile_ret_types[] = { bt_type_module(context), boltstd_get_error_type(context) };
 	bt_Type* trycompile_ret = bt_make_union_from(context, trycompile_ret_types, 2);
+
+	bt_Type* optional_error = bt_type_make_nullable(context, boltstd_get_error_type(context));
 	
 	bt_Type* regtype_args[]         = { string, type };
 	bt_Type* getenumname_args[]     = { type,   any };
@@ -299,6 +389,9 @@ void boltstd_open_meta(bt_Context* context)
 	bt_module_export_native(context, module, "remove_reference",  btstd_remove_reference,      number,         &any,                 1);
 	bt_module_export_native(context, module, "mem_size",          btstd_memsize,               number,         NULL,                 0);
 	bt_module_export_native(context, module, "next_cycle",        btstd_nextcycle,             number,         NULL,                 0);
+	bt_module_export_native(context, module, "gc_stats",          btstd_gc_stats,              stats_type,     NULL,                 0);
+	bt_module_export_native(context, module, "gc_pause_percentile", btstd_gc_pause_percentile, number,         &number,              1);
+	bt_module_export_native(context, module, "heap_snapshot",     btstd_heap_snapshot,         optional_error, &string,              1);
 	bt_module_export_native(context, module, "register_type",     btstd_register_type,         NULL,           regtype_args,         2);
 	bt_module_export_native(context, module, "find_type",         btstd_find_type,             findtype_ret,   &string,              1);
 	bt_module_export_native(context, module, "get_enum_name",     btstd_get_enum_name,         string,         getenumname_args,     2);
@@ -19,14 +19,14 @@ static void btregex_compile(bt_Context* ctx, bt_Thread* thread)
     bt_String* source = (bt_String*)bt_object(bt_arg(thread, 0));
 
     const char* err = NULL;
-    int size = pm_expsize(bt_string_get(source), &err);
+    int size = pm_expsize(bt_string_cstr(ctx, source), &err);
     if (size == 0) {
         bt_return(thread, boltstd_make_error(ctx, err));
         return;
     }
 
     pm_Regex* result = bt_gc_alloc(ctx, size);
-    if (!pm_compile(result, size, bt_string_get(source))) {
+    if (!pm_compile(result, size, bt_string_cstr(ctx, source))) {
         bt_return(thread, boltstd_make_error(ctx, pm_geterror(result)));
         bt_gc_free(ctx, result, size);
         return;
@@ -82,7 +82,7 @@ static void btregex_match(bt_Context* ctx, bt_Thread* thread)
     if (pm_match(regex->regex, bt_string_get(pattern), (int)bt_string_length(pattern), regex->capture_groups, (int)regex->group_count, 0)) {
         bt_Array* result = bt_make_array(ctx, (uint32_t)regex->group_count);
         for (size_t i = 0; i < regex->group_count; i++) {
-            bt_array_push(ctx, result, bt_value((bt_Object*)bt_make_string_len(ctx, bt_string_get(pattern) + regex->capture_groups[i].start, regex->capture_groups[i].length)));
+            bt_array_push(ctx, result, bt_value((bt_Object*)bt_make_string_slice(ctx, pattern, regex->capture_groups[i].start, regex->capture_groups[i].length)));
         }
 
         bt_return(thread, bt_value((bt_Object*)result));
@@ -122,7 +122,7 @@ static void bt_regex_all_iter(bt_Context* ctx, bt_Thread* thread)
     if (pm_match(regex->regex, str, (int)len, regex->capture_groups, (int)regex->group_count, &remainder)) {
         bt_Array* result = bt_make_array(ctx, (uint32_t)regex->group_count);
         for (size_t i = 0; i < regex->group_count; i++) {
-            bt_array_push(ctx, result, bt_value((bt_Object*)bt_make_string_len(ctx, str + regex->capture_groups[i].start, regex->capture_groups[i].length)));
+            bt_array_push(ctx, result, bt_value((bt_Object*)bt_make_string_slice(ctx, pattern, (uint32_t)old_remainder + regex->capture_groups[i].start, regex->capture_groups[i].length)));
         }
 
         bt_return(thread, bt_value((bt_Object*)result));
@@ -6,6 +6,14 @@
 #include <string.h>
 #include <stdio.h>
 
+static const char* builder_type_name = "StringBuilder";
+
+typedef struct btstr_Builder {
+	char* data;
+	uint32_t length;
+	uint32_t capacity;
+} btstr_Builder;
+
 static void bt_str_length(bt_Context* ctx, bt_Thread* thread)
 {
 	bt_Value arg = bt_arg(thread, 0);
@@ -22,7 +30,7 @@ static void bt_str_substring(bt_Context* ctx, bt_Thread* thread)
 	if (start < 0 || start > str->len) bt_runtime_error(thread, "Attempted to substring outside of bounds!", NULL);
 	if (length <= 0 || start + length > str->len) bt_runtime_error(thread, "Invalid size for substring!", NULL);
 
-	bt_String* substring = bt_make_string_len(ctx, BT_STRING_STR(str) + start, length);
+	bt_String* substring = bt_make_string_slice(ctx, str, start, length);
 	bt_return(thread, BT_VALUE_OBJECT(substring));
 }
 
@@ -33,7 +41,7 @@ static void bt_str_remainder(bt_Context* ctx, bt_Thread* thread)
 
 	if (start < 0 || start > str->len) bt_runtime_error(thread, "Attempted to substring outside of bounds!", NULL);
 
-	bt_String* substring = bt_make_string_len(ctx, BT_STRING_STR(str) + start, str->len - start);
+	bt_String* substring = bt_make_string_slice(ctx, str, start, str->len - start);
 	bt_return(thread, BT_VALUE_OBJECT(substring));
 }
 
@@ -41,13 +49,15 @@ static void bt_strings_concat(bt_Context* ctx, bt_Thread* thread)
 {
 	uint8_t argc = bt_argc(thread);
 
-	uint32_t total_len = 0;
+	uint64_t total_len = 0;
 	for (uint8_t i = 0; i < argc; i++) {
 		bt_String* str = (bt_String*)bt_object(bt_arg(thread, i));
 		total_len += str->len;
 	}
 
-	bt_String* result = bt_make_string_empty(ctx, total_len);
+	if (total_len > BT_STRING_MAX_LEN) bt_runtime_error(thread, "String exceeds the maximum length!", NULL);
+
+	bt_String* result = bt_make_string_empty(ctx, (uint32_t)total_len);
 
 	uint32_t progress = 0;
 	for (uint8_t i = 0; i < argc; i++) {
@@ -61,60 +71,232 @@ static void bt_strings_concat(bt_Context* ctx, bt_Thread* thread)
 	bt_return(thread, BT_VALUE_OBJECT(result));
 }
 
-typedef bt_Buffer(char) bt_StringBuffer;
-
-static void push_string(bt_Context* ctx, bt_StringBuffer* output, const char* cstr, size_t len)
+// Format strings are compiled once into a list of ops, and cached by the identity of the format string.
+// Literal format strings are interned constants, so each call site hits the same entry every time
+#define FORMAT_CACHE_SIZE 64
+// The number of specifiers and bytes of rendered arguments that fit on the stack while formatting
+#define FORMAT_INLINE_PIECES 16
+#define FORMAT_INLINE_SCRATCH 512
+// Enough ops for any template whose specifiers fit in the inline pieces
+#define FORMAT_INLINE_OPS (FORMAT_INLINE_PIECES * 2 + 1)
+
+static const char* format_cache_type_name = "FormatCache";
+static const char format_invalid[] = "<invalid>";
+static const char format_unknown_specifier[] = "<unknown specicier>";
+
+typedef enum {
+	FORMAT_OP_LITERAL,
+	FORMAT_OP_INT,
+	FORMAT_OP_FLOAT,
+	FORMAT_OP_STRING,
+	FORMAT_OP_UNKNOWN,
+} btstr_FormatOpKind;
+
+// Literal ops reference `length` bytes of the format string at `offset`, the rest consume an argument
+typedef struct btstr_FormatOp {
+	uint8_t kind;
+	uint32_t offset;
+	uint32_t length;
+} btstr_FormatOp;
+
+typedef struct btstr_FormatTemplate {
+	btstr_FormatOp* ops;
+	uint32_t op_count;
+	uint32_t op_capacity;
+	uint32_t spec_count;
+	uint32_t fixed_length;
+} btstr_FormatTemplate;
+
+typedef struct btstr_FormatCache {
+	btstr_FormatTemplate entries[FORMAT_CACHE_SIZE];
+} btstr_FormatCache;
+
+// The format strings of each cache entry are kept in the module's `format_cache_keys` array, which also keeps them
+// alive so that their addresses can't be reused by another string while they're cached. The slot past the last key
+// holds the cache userdata itself, so a single storage lookup finds both
+static const char* format_cache_keys_name = "format_cache_keys";
+
+static void format_template_free(bt_Context* ctx, btstr_FormatTemplate* tmpl)
 {
-	bt_buffer_reserve(output, ctx, output->length + len);
+	if (tmpl->ops) bt_gc_free(ctx, tmpl->ops, sizeof(btstr_FormatOp) * tmpl->op_capacity);
+	tmpl->ops = NULL;
+	tmpl->op_count = 0;
+	tmpl->op_capacity = 0;
+}
 
-	for (uint32_t i = 0; i < len; i++) {
-		bt_buffer_push(ctx, output, cstr[i]);
+static void format_cache_finalizer(bt_Context* ctx, bt_Userdata* userdata)
+{
+	btstr_FormatCache* cache = bt_userdata_get(userdata);
+	for (uint32_t i = 0; i < FORMAT_CACHE_SIZE; i++) {
+		format_template_free(ctx, cache->entries + i);
 	}
 }
 
-static void sprint_invalid(bt_Context* ctx, bt_StringBuffer* output) 
+static void format_template_compile(bt_Context* ctx, bt_Object* owner, btstr_FormatTemplate* tmpl, const char* format, uint32_t len)
 {
-	const char* to_format = "<invalid>";
-	push_string(ctx, output, to_format, strlen(to_format));
+	// Every specifier splits off at most one literal, so this bounds the number of ops
+	uint32_t max_ops = 1;
+	for (uint32_t i = 0; i < len; i++) {
+		if (format[i] == '%') max_ops += 2;
+	}
+
+	// Templates outlive any arena that happens to be active, so they're owned by the cache
+	tmpl->ops = bt_gc_alloc_owned(ctx, owner, sizeof(btstr_FormatOp) * max_ops);
+	tmpl->op_count = 0;
+	tmpl->op_capacity = max_ops;
+	tmpl->spec_count = 0;
+	tmpl->fixed_length = 0;
+
+	uint32_t literal_start = 0;
+	for (uint32_t i = 0; i <= len; i++) {
+		if (i < len && format[i] != '%') continue;
+
+		if (i > literal_start) {
+			tmpl->ops[tmpl->op_count++] = (btstr_FormatOp){ FORMAT_OP_LITERAL, literal_start, i - literal_start };
+			tmpl->fixed_length += i - literal_start;
+		}
+
+		if (i == len) break;
+
+		char specifier = i + 1 < len ? format[i + 1] : 0;
+		literal_start = i + 2;
+
+		btstr_FormatOpKind kind;
+		switch (specifier) {
+		case '%':
+			// Start the next literal at the second '%', so it's emitted as part of it
+			literal_start = i + 1;
+			i++;
+			continue;
+		case 'd': case 'i': kind = FORMAT_OP_INT; break;
+		case 'f': kind = FORMAT_OP_FLOAT; break;
+		case 's': case 'v': kind = FORMAT_OP_STRING; break;
+		default: kind = FORMAT_OP_UNKNOWN; break;
+		}
+
+		if (kind == FORMAT_OP_UNKNOWN) {
+			tmpl->fixed_length += sizeof(format_unknown_specifier) - 1;
+			// A trailing '%' has no specifier to skip
+			if (!specifier) literal_start = len;
+		}
+		else {
+			tmpl->spec_count++;
+		}
+
+		tmpl->ops[tmpl->op_count++] = (btstr_FormatOp){ kind, 0, 0 };
+		i++;
+	}
 }
 
-static void sptint_unknown_specifier(bt_Context* ctx, bt_StringBuffer* output)
+static btstr_FormatTemplate* format_template_get(bt_Context* ctx, bt_Array* keys, bt_String* format)
 {
-	const char* to_format = "<unknown specicier>";
-	push_string(ctx, output, to_format, strlen(to_format));
+	bt_Userdata* cache = (bt_Userdata*)bt_object(keys->items[FORMAT_CACHE_SIZE]);
+
+	uint32_t slot = (uint32_t)(((uintptr_t)format >> 4) & (FORMAT_CACHE_SIZE - 1));
+	btstr_FormatTemplate* tmpl = ((btstr_FormatCache*)bt_userdata_get(cache))->entries + slot;
+
+	if (keys->items[slot] != BT_VALUE_OBJECT(format)) {
+		format_template_free(ctx, tmpl);
+		format_template_compile(ctx, (bt_Object*)cache, tmpl, BT_STRING_STR(format), format->len);
+		keys->items[slot] = BT_VALUE_OBJECT(format);
+	}
+
+	return tmpl;
 }
 
-static void sprint_uint64_t(bt_Context* ctx, bt_StringBuffer* output, bt_Value value)
+// Arguments are rendered before the result is allocated, numbers into scratch space and strings by reference
+typedef struct btstr_FormatPiece {
+	const char* str;
+	uint32_t scratch_offset;
+	uint32_t length;
+} btstr_FormatPiece;
+
+typedef struct btstr_FormatScratch {
+	char* data;
+	uint32_t length, capacity;
+	char inline_data[FORMAT_INLINE_SCRATCH];
+} btstr_FormatScratch;
+
+static char* format_scratch_reserve(bt_Context* ctx, btstr_FormatScratch* scratch, uint32_t size)
 {
-	if (!bt_is_number(value)) {
-		sprint_invalid(ctx, output);
-		return;
-	}
+	if (scratch->length + size > scratch->capacity) {
+		uint32_t capacity = scratch->capacity * 2;
+		if (capacity < scratch->length + size) capacity = scratch->length + size;
 
-	char buf[128];
-	int32_t len = sprintf(buf, "%llu", (uint64_t)BT_AS_NUMBER(value));
+		char* data = bt_gc_alloc(ctx, capacity);
+		memcpy(data, scratch->data, scratch->length);
+		if (scratch->data != scratch->inline_data) bt_gc_free(ctx, scratch->data, scratch->capacity);
 
-	push_string(ctx, output, buf, len);
+		scratch->data = data;
+		scratch->capacity = capacity;
+	}
+
+	return scratch->data + scratch->length;
 }
 
-static void sprint_float(bt_Context* ctx, bt_StringBuffer* output, bt_Value value)
+static void format_render_number(bt_Context* ctx, btstr_FormatScratch* scratch, btstr_FormatPiece* piece, bt_Value value, bt_bool is_float)
 {
 	if (!bt_is_number(value)) {
-		sprint_invalid(ctx, output);
+		piece->str = format_invalid;
+		piece->length = sizeof(format_invalid) - 1;
+		return;
+	}
+
+	// Small integers already have a shared string to copy from, which outlives the call
+	bt_String* common = is_float ? NULL : bt_to_common_string(ctx, value);
+	if (common) {
+		piece->str = BT_STRING_STR(common);
+		piece->length = common->len;
 		return;
 	}
 
-	char buf[128];
-	int32_t len = sprintf(buf, "%f", BT_AS_NUMBER(value));
+	char* buf = format_scratch_reserve(ctx, scratch, BT_NUMBER_MAX_CHARS + 2);
+	int32_t len;
+
+	if (is_float) {
+		len = bt_number_to_chars(buf, BT_AS_NUMBER(value));
 
-	push_string(ctx, output, buf, len);
+		// Always show a fractional part, unless the number is written in some other form (exponent, inf, nan)
+		bt_bool plain = BT_TRUE;
+		for (int32_t i = 0; i < len; ++i) {
+			if (buf[i] != '-' && (buf[i] < '0' || buf[i] > '9')) plain = BT_FALSE;
+		}
+		if (plain) {
+			buf[len++] = '.';
+			buf[len++] = '0';
+		}
+	}
+	else {
+		len = bt_int_to_chars(buf, (int64_t)BT_AS_NUMBER(value));
+	}
+
+	piece->str = NULL;
+	piece->scratch_offset = scratch->length;
+	piece->length = len;
+	scratch->length += len;
 }
 
-static void sprint_string(bt_Context* ctx, bt_StringBuffer* output, bt_Value value)
+static void format_render_string(bt_Context* ctx, btstr_FormatScratch* scratch, btstr_FormatPiece* piece, bt_Value value)
 {
-	bt_String* as_str = bt_to_string(ctx, value);
+	// Strings are arguments, and so stay alive until the result has been written
+	bt_String* str = NULL;
+	if (BT_IS_OBJECT(value) && BT_OBJECT_GET_TYPE(BT_AS_OBJECT(value)) == BT_OBJECT_TYPE_STRING) str = (bt_String*)BT_AS_OBJECT(value);
+	else str = bt_to_common_string(ctx, value);
+
+	if (str) {
+		piece->str = BT_STRING_STR(str);
+		piece->length = str->len;
+		return;
+	}
 
-	push_string(ctx, output, BT_STRING_STR(as_str), as_str->len);
+	char buffer[BT_TO_STRING_BUF_LENGTH];
+	int32_t len = bt_to_string_inplace(ctx, buffer, BT_TO_STRING_BUF_LENGTH, value);
+	memcpy(format_scratch_reserve(ctx, scratch, len), buffer, len);
+
+	piece->str = NULL;
+	piece->scratch_offset = scratch->length;
+	piece->length = len;
+	scratch->length += len;
 }
 
 static void bt_string_format(bt_Context* ctx, bt_Thread* thread)
@@ -122,98 +304,193 @@ static void bt_string_format(bt_Context* ctx, bt_Thread* thread)
 	uint8_t argc = bt_argc(thread);
 
 	bt_String* format = (bt_String*)bt_object(bt_arg(thread, 0));
+	const char* format_str = BT_STRING_STR(format);
+
+	bt_Module* module = bt_get_module(thread);
+	bt_Array* cache_keys = (bt_Array*)bt_object(bt_module_get_storage(module, BT_VALUE_CSTRING(ctx, format_cache_keys_name)));
+
+	// Arena strings are released wholesale by `bt_arena_reset`, so they can't be held on to as cache keys
+	btstr_FormatOp inline_ops[FORMAT_INLINE_OPS];
+	btstr_FormatTemplate tmpl = { 0 };
+	if (ctx->gc.arena_depth && bt_arena_owns(ctx, format)) {
+		format_template_compile(ctx, bt_object(cache_keys->items[FORMAT_CACHE_SIZE]), &tmpl, format_str, format->len);
+	}
+	else {
+		// Rendering a `%s` can run script through `@format`, which may format again and evict this very cache entry,
+		// so the ops are copied out instead of being read from the cache while the arguments render
+		btstr_FormatTemplate* cached = format_template_get(ctx, cache_keys, format);
+		tmpl = *cached;
+		tmpl.ops = cached->op_count > FORMAT_INLINE_OPS ? bt_gc_alloc(ctx, sizeof(btstr_FormatOp) * cached->op_count) : inline_ops;
+		tmpl.op_capacity = cached->op_count;
+		memcpy(tmpl.ops, cached->ops, sizeof(btstr_FormatOp) * cached->op_count);
+	}
+
+	btstr_FormatPiece inline_pieces[FORMAT_INLINE_PIECES];
+	btstr_FormatPiece* pieces = tmpl.spec_count > FORMAT_INLINE_PIECES
+		? bt_gc_alloc(ctx, sizeof(btstr_FormatPiece) * tmpl.spec_count) : inline_pieces;
+	uint32_t piece_count = tmpl.spec_count;
 
-	bt_StringBuffer output;
-	bt_buffer_empty(&output);
+	btstr_FormatScratch scratch;
+	scratch.data = scratch.inline_data;
+	scratch.length = 0;
+	scratch.capacity = FORMAT_INLINE_SCRATCH;
 
+	uint64_t total_length = tmpl.fixed_length;
 	uint8_t current_arg = 1;
+	uint32_t current_piece = 0;
 
-	char* current_format = BT_STRING_STR(format);
-	while (*current_format) {
-		if (*current_format == '%') {
-			char specifier = *(++current_format);
-			current_format++;
-
-			switch (specifier) {
-			case '%':
-				bt_buffer_push(ctx, &output, '%');
-				break;
-			case 'd': case 'i':
-				sprint_uint64_t(ctx, &output, current_arg < argc ? bt_arg(thread, current_arg++) : BT_VALUE_NULL);
-				break;
-			case 'f':
-				sprint_float(ctx, &output, current_arg < argc ? bt_arg(thread, current_arg++) : BT_VALUE_NULL);
-				break;
-			case 's': case 'v':
-				sprint_string(ctx, &output, current_arg < argc ? bt_arg(thread, current_arg++) : BT_VALUE_NULL);
-				break;
-			default:
-				sptint_unknown_specifier(ctx, &output);
-				break;
-			}
-		}
-		else {
-			bt_buffer_push(ctx, &output, *current_format);
-			current_format++;
+	for (uint32_t i = 0; i < tmpl.op_count; i++) {
+		btstr_FormatOp op = tmpl.ops[i];
+		if (op.kind == FORMAT_OP_LITERAL || op.kind == FORMAT_OP_UNKNOWN) continue;
+
+		bt_Value arg = current_arg < argc ? bt_arg(thread, current_arg++) : BT_VALUE_NULL;
+		btstr_FormatPiece* piece = pieces + current_piece++;
+
+		if (op.kind == FORMAT_OP_STRING) format_render_string(ctx, &scratch, piece, arg);
+		else format_render_number(ctx, &scratch, piece, arg, op.kind == FORMAT_OP_FLOAT);
+
+		total_length += piece->length;
+	}
+
+	if (total_length > BT_STRING_MAX_LEN) {
+		if (pieces != inline_pieces) bt_gc_free(ctx, pieces, sizeof(btstr_FormatPiece) * piece_count);
+		if (scratch.data != scratch.inline_data) bt_gc_free(ctx, scratch.data, scratch.capacity);
+		if (tmpl.ops != inline_ops) format_template_free(ctx, &tmpl);
+		bt_runtime_error(thread, "String exceeds the maximum length!", NULL);
+	}
+
+	bt_String* result = bt_make_string_empty(ctx, (uint32_t)total_length);
+	char* out = BT_STRING_STR(result);
+	current_piece = 0;
+
+	for (uint32_t i = 0; i < tmpl.op_count; i++) {
+		btstr_FormatOp op = tmpl.ops[i];
+		switch (op.kind) {
+		case FORMAT_OP_LITERAL:
+			memcpy(out, format_str + op.offset, op.length);
+			out += op.length;
+			break;
+		case FORMAT_OP_UNKNOWN:
+			memcpy(out, format_unknown_specifier, sizeof(format_unknown_specifier) - 1);
+			out += sizeof(format_unknown_specifier) - 1;
+			break;
+		default: {
+			btstr_FormatPiece* piece = pieces + current_piece++;
+			memcpy(out, piece->str ? piece->str : scratch.data + piece->scratch_offset, piece->length);
+			out += piece->length;
+		} break;
 		}
 	}
 
-	bt_buffer_push(ctx, &output, '\0');
+	*out = 0;
 
-	bt_String* result = bt_make_string_len(ctx, output.elements, output.length);
-	bt_buffer_destroy(ctx, &output);
+	if (pieces != inline_pieces) bt_gc_free(ctx, pieces, sizeof(btstr_FormatPiece) * piece_count);
+	if (scratch.data != scratch.inline_data) bt_gc_free(ctx, scratch.data, scratch.capacity);
+	if (tmpl.ops != inline_ops) format_template_free(ctx, &tmpl);
 
 	bt_return(thread, BT_VALUE_OBJECT(result));
 }
 
+// Returns the index of the first occurrence of `needle` in `haystack` at or after `from`, or -1
+static int64_t string_search(const char* haystack, uint32_t haystack_len, const char* needle, uint32_t needle_len, uint32_t from)
+{
+	if (needle_len == 0) return from <= haystack_len ? from : -1;
+	if (needle_len > haystack_len || from > haystack_len - needle_len) return -1;
+
+	uint32_t last = haystack_len - needle_len;
+	uint32_t i = from;
+	char first_char = needle[0];
+	char last_char = needle[needle_len - 1];
+
+#ifdef BT_SIMD_SSE2
+	// Compare 16 candidate positions at once against both the first and last byte of the needle,
+	// only positions where both match are verified in full
+	__m128i first = _mm_set1_epi8(first_char);
+	__m128i final = _mm_set1_epi8(last_char);
+	for (; i + 16 <= last + 1; i += 16) {
+		__m128i block_first = _mm_loadu_si128((const __m128i*)(haystack + i));
+		__m128i block_last = _mm_loadu_si128((const __m128i*)(haystack + i + needle_len - 1));
+		uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, final)));
+
+		while (mask) {
+			uint32_t bit = 0;
+			while (!(mask & (1u << bit))) bit++;
+			if (memcmp(haystack + i + bit + 1, needle + 1, needle_len - 1) == 0) return i + bit;
+			mask &= mask - 1;
+		}
+	}
+#endif
+
+	while (i <= last) {
+		const char* candidate = memchr(haystack + i, first_char, last - i + 1);
+		if (!candidate) return -1;
+
+		i = (uint32_t)(candidate - haystack);
+		if (haystack[i + needle_len - 1] == last_char && memcmp(haystack + i + 1, needle + 1, needle_len - 1) == 0) return i;
+		i++;
+	}
+
+	return -1;
+}
+
 static void bt_string_find(bt_Context* ctx, bt_Thread* thread)
 {
 	bt_String* source = (bt_String*)bt_object(bt_arg(thread, 0));
 	bt_String* needle = (bt_String*)bt_object(bt_arg(thread, 1));
 
-	for (uint32_t i = 0; i < (source->len - needle->len) + 1; ++i) {
-		const char* start = BT_STRING_STR(source) + i;
+	int64_t found = string_search(BT_STRING_STR(source), source->len, BT_STRING_STR(needle), needle->len, 0);
+	bt_return(thread, BT_VALUE_NUMBER((double)found));
+}
+
+static void bt_string_contains(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_String* source = (bt_String*)bt_object(bt_arg(thread, 0));
+	bt_String* needle = (bt_String*)bt_object(bt_arg(thread, 1));
+
+	int64_t found = string_search(BT_STRING_STR(source), source->len, BT_STRING_STR(needle), needle->len, 0);
+	bt_return(thread, bt_make_bool(found != -1));
+}
 
-		int32_t found = (int32_t)i;
-		for (uint32_t j = 0; j < needle->len; j++) {
-			if (start[j] != BT_STRING_STR(needle)[j]) {
-				found = -1;
-				break;
-			}
-		}
+static void bt_string_count(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_String* source = (bt_String*)bt_object(bt_arg(thread, 0));
+	bt_String* needle = (bt_String*)bt_object(bt_arg(thread, 1));
 
-		if (found != -1) {
-			bt_return(thread, BT_VALUE_NUMBER((double)found));
-			return;
-		}
+	if (needle->len == 0) bt_runtime_error(thread, "Cannot count empty string!", NULL);
+
+	uint32_t count = 0;
+	int64_t found = 0;
+	while ((found = string_search(BT_STRING_STR(source), source->len, BT_STRING_STR(needle), needle->len, (uint32_t)found)) != -1) {
+		count++;
+		found += needle->len;
 	}
 
-	bt_return(thread, BT_VALUE_NUMBER((double)-1));
+	bt_return(thread, BT_VALUE_NUMBER(count));
 }
 
-static void bt_string_contains(bt_Context* ctx, bt_Thread* thread)
+static void bt_string_split(bt_Context* ctx, bt_Thread* thread)
 {
 	bt_String* source = (bt_String*)bt_object(bt_arg(thread, 0));
-	bt_String* needle = (bt_String*)bt_object(bt_arg(thread, 1));
+	bt_String* separator = (bt_String*)bt_object(bt_arg(thread, 1));
 
-	for (uint32_t i = 0; i < (source->len - needle->len) + 1; ++i) {
-		const char* start = BT_STRING_STR(source) + i;
+	if (separator->len == 0) bt_runtime_error(thread, "Separator cannot be empty!", NULL);
 
-		int32_t found = (int32_t)i;
-		for (uint32_t j = 0; j < needle->len; j++) {
-			if (start[j] != BT_STRING_STR(needle)[j]) {
-				found = -1;
-				break;
-			}
-		}
+	bt_Array* result = bt_make_array(ctx, 4);
+	bt_push_root(ctx, (bt_Object*)result);
 
-		if (found != -1) {
-			bt_return(thread, bt_make_bool(1));
-			return;
-		}
+	uint32_t piece_start = 0;
+	int64_t found;
+	while ((found = string_search(BT_STRING_STR(source), source->len, BT_STRING_STR(separator), separator->len, piece_start)) != -1) {
+		bt_String* piece = bt_make_string_slice(ctx, source, piece_start, (uint32_t)found - piece_start);
+		bt_array_push(ctx, result, BT_VALUE_OBJECT(piece));
+		piece_start = (uint32_t)found + separator->len;
 	}
-	
-	bt_return(thread, bt_make_bool(0));
+
+	bt_String* piece = bt_make_string_slice(ctx, source, piece_start, source->len - piece_start);
+	bt_array_push(ctx, result, BT_VALUE_OBJECT(piece));
+
+	bt_pop_root(ctx);
+	bt_return(thread, BT_VALUE_OBJECT(result));
 }
 
 static void bt_string_replace(bt_Context* ctx, bt_Thread* thread) 
@@ -222,33 +499,43 @@ static void bt_string_replace(bt_Context* ctx, bt_Thread* thread)
 	bt_String* rep_str = (bt_String*)bt_object(bt_arg(thread, 1));
 	bt_String* with_str = (bt_String*)bt_object(bt_arg(thread, 2));
 
-	char* orig = BT_STRING_STR(orig_str);
-	char* rep = BT_STRING_STR(rep_str);
-	char* with = BT_STRING_STR(with_str);
+	if (rep_str->len == 0) bt_runtime_error(thread, "Replacement string cannot be empty!", NULL); // empty rep causes infinite loop during count
 
-	size_t len_rep = strlen(rep);
-	if (len_rep == 0) bt_runtime_error(thread, "Replacement string cannot be empty!", NULL); // empty rep causes infinite loop during count
-	size_t len_with = strlen(with);
+	const char* orig = BT_STRING_STR(orig_str);
+	const char* rep = BT_STRING_STR(rep_str);
+	const char* with = BT_STRING_STR(with_str);
 
-	char* tmp;
-	char* ins = orig;
-	uint32_t count;
-	for (count = 0; (tmp = strstr(ins, rep)); ++count) {
-		ins = tmp + len_rep;
+	// Count matches first, so the result is allocated at its exact size and filled in one go
+	uint32_t count = 0;
+	int64_t found = 0;
+	while ((found = string_search(orig, orig_str->len, rep, rep_str->len, (uint32_t)found)) != -1) {
+		count++;
+		found += rep_str->len;
 	}
 
-	bt_String* result = bt_make_string_empty(ctx, orig_str->len + (uint32_t)(len_with - len_rep) * count + 1);
-	tmp = BT_STRING_STR(result);
+	if (count == 0) {
+		bt_return(thread, BT_VALUE_OBJECT(orig_str));
+		return;
+	}
+
+	uint64_t result_len = (uint64_t)orig_str->len - (uint64_t)rep_str->len * count + (uint64_t)with_str->len * count;
+	if (result_len > BT_STRING_MAX_LEN) bt_runtime_error(thread, "String exceeds the maximum length!", NULL);
 
-	int64_t len_front;
+	bt_String* result = bt_make_string_empty(ctx, (uint32_t)result_len);
+	char* out = BT_STRING_STR(result);
+
+	uint32_t copied_from = 0;
 	while (count--) {
-		ins = strstr(orig, rep);
-		len_front = ins - orig;
-		tmp = strncpy(tmp, orig, len_front) + len_front;
-		tmp = strcpy(tmp, with) + len_with;
-		orig += len_front + len_rep;
+		found = string_search(orig, orig_str->len, rep, rep_str->len, copied_from);
+
+		uint32_t len_front = (uint32_t)found - copied_from;
+		memcpy(out, orig + copied_from, len_front);
+		out += len_front;
+		memcpy(out, with, with_str->len);
+		out += with_str->len;
+		copied_from = (uint32_t)found + rep_str->len;
 	}
-	strcpy(tmp, orig);
+	memcpy(out, orig + copied_from, orig_str->len - copied_from);
 
 	bt_return(thread, BT_VALUE_OBJECT(result));
 }
@@ -295,7 +582,7 @@ static void bt_string_starts_with(bt_Context* ctx, bt_Thread* thread) {
 		return;
 	}
 
-	bt_return(thread, bt_make_bool(strncmp(bt_string_get(self), bt_string_get(arg), bt_string_length(arg)) == 0));
+	bt_return(thread, bt_make_bool(memcmp(BT_STRING_STR(self), BT_STRING_STR(arg), arg->len) == 0));
 }
 
 static void bt_string_ends_with(bt_Context* ctx, bt_Thread* thread) {
@@ -307,7 +594,7 @@ static void bt_string_ends_with(bt_Context* ctx, bt_Thread* thread) {
 		return;
 	}
 
-	bt_return(thread, bt_make_bool(strncmp(bt_string_get(self) + bt_string_length(self) - 1 - bt_string_length(arg), bt_string_get(arg), bt_string_length(arg)) == 0));
+	bt_return(thread, bt_make_bool(memcmp(BT_STRING_STR(self) + self->len - arg->len, BT_STRING_STR(arg), arg->len) == 0));
 }
 
 static void bt_string_compare_at(bt_Context* ctx, bt_Thread* thread) {
@@ -324,6 +611,104 @@ static void bt_string_compare_at(bt_Context* ctx, bt_Thread* thread) {
 	bt_return(thread, bt_make_bool(strncmp(bt_string_get(self) + idx, bt_string_get(arg), bt_string_length(arg)) == 0));
 }
 
+static void btstr_builder_finalizer(bt_Context* ctx, bt_Userdata* userdata)
+{
+	btstr_Builder* builder = bt_userdata_get(userdata);
+	if (builder->data) {
+		bt_gc_free(ctx, builder->data, builder->capacity);
+		builder->data = NULL;
+		builder->capacity = 0;
+		builder->length = 0;
+	}
+}
+
+static void btstr_builder_reserve_(bt_Context* ctx, bt_Userdata* userdata, uint64_t needed)
+{
+	btstr_Builder* builder = bt_userdata_get(userdata);
+	if (needed <= builder->capacity) return;
+
+	// The contents have to fit in a string eventually, so that bounds the buffer too
+	if (needed > BT_STRING_MAX_LEN) bt_runtime_error(ctx->current_thread, "String builder exceeds the maximum string length!", NULL);
+
+	// Doubling keeps appends amortized O(1), however many pieces the result is built from
+	uint64_t new_capacity = builder->capacity ? (uint64_t)builder->capacity * 2 : 32;
+	if (new_capacity < needed) new_capacity = needed;
+	if (new_capacity > BT_STRING_MAX_LEN) new_capacity = BT_STRING_MAX_LEN;
+
+	builder->data = bt_gc_realloc_owned(ctx, (bt_Object*)userdata, builder->data, builder->capacity, (size_t)new_capacity);
+	builder->capacity = (uint32_t)new_capacity;
+}
+
+static void btstr_builder(bt_Context* ctx, bt_Thread* thread)
+{
+	btstr_Builder builder = { NULL, 0, 0 };
+
+	bt_Module* module = bt_get_module(thread);
+	bt_Type* builder_type = (bt_Type*)bt_object(bt_module_get_storage(module, BT_VALUE_CSTRING(ctx, builder_type_name)));
+
+	bt_Userdata* result = bt_make_userdata(ctx, builder_type, &builder, sizeof(btstr_Builder));
+	bt_return(thread, BT_VALUE_OBJECT(result));
+}
+
+static void btstr_builder_append(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Userdata* userdata = (bt_Userdata*)bt_object(bt_arg(thread, 0));
+	bt_Value value = bt_arg(thread, 1);
+
+	if (BT_IS_OBJECT(value) && BT_OBJECT_GET_TYPE(BT_AS_OBJECT(value)) == BT_OBJECT_TYPE_STRING) {
+		bt_String* str = (bt_String*)BT_AS_OBJECT(value);
+		btstr_Builder* builder = bt_userdata_get(userdata);
+		btstr_builder_reserve_(ctx, userdata, (uint64_t)builder->length + str->len);
+		memcpy(builder->data + builder->length, BT_STRING_STR(str), str->len);
+		builder->length += str->len;
+	}
+	else {
+		// Anything else is formatted straight into the builder, without making an intermediate string
+		char buffer[BT_TO_STRING_BUF_LENGTH];
+		int32_t len = bt_to_string_inplace(ctx, buffer, BT_TO_STRING_BUF_LENGTH, value);
+
+		btstr_Builder* builder = bt_userdata_get(userdata);
+		btstr_builder_reserve_(ctx, userdata, (uint64_t)builder->length + len);
+		memcpy(builder->data + builder->length, buffer, len);
+		builder->length += len;
+	}
+
+	bt_return(thread, BT_VALUE_OBJECT(userdata));
+}
+
+static void btstr_builder_reserve(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Userdata* userdata = (bt_Userdata*)bt_object(bt_arg(thread, 0));
+	bt_number capacity = bt_get_number(bt_arg(thread, 1));
+
+	if (!(capacity >= 0 && capacity <= BT_STRING_MAX_LEN)) bt_runtime_error(thread, "Invalid capacity for string builder!", NULL);
+
+	btstr_builder_reserve_(ctx, userdata, (uint64_t)capacity);
+}
+
+static void btstr_builder_length(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Userdata* userdata = (bt_Userdata*)bt_object(bt_arg(thread, 0));
+	btstr_Builder* builder = bt_userdata_get(userdata);
+	bt_return(thread, BT_VALUE_NUMBER(builder->length));
+}
+
+static void btstr_builder_clear(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Userdata* userdata = (bt_Userdata*)bt_object(bt_arg(thread, 0));
+	btstr_Builder* builder = bt_userdata_get(userdata);
+	builder->length = 0;
+}
+
+static void btstr_builder_to_string(bt_Context* ctx, bt_Thread* thread)
+{
+	bt_Userdata* userdata = (bt_Userdata*)bt_object(bt_arg(thread, 0));
+	btstr_Builder* builder = bt_userdata_get(userdata);
+
+	bt_String* result = bt_make_string_len(ctx, builder->data ? builder->data : "", builder->length);
+	bt_return(thread, BT_VALUE_OBJECT(result));
+}
+
 void boltstd_open_strings(bt_Context* context)
 {
 	bt_Module* module = bt_make_module(context);
@@ -386,6 +771,18 @@ void boltstd_open_strings(bt_Context* context)
 	bt_type_add_field(context, string, replace_sig, BT_VALUE_CSTRING(context, "replace"), BT_VALUE_OBJECT(fn_ref));
 	bt_module_export(context, module, replace_sig, BT_VALUE_CSTRING(context, "replace"), BT_VALUE_OBJECT(fn_ref));
 
+	bt_Type* count_sig = bt_make_signature_type(context, number, find_args, 2);
+	fn_ref = bt_make_native(context, module, count_sig, bt_string_count);
+
+	bt_type_add_field(context, string, count_sig, BT_VALUE_CSTRING(context, "count"), BT_VALUE_OBJECT(fn_ref));
+	bt_module_export(context, module, count_sig, BT_VALUE_CSTRING(context, "count"), BT_VALUE_OBJECT(fn_ref));
+
+	bt_Type* split_sig = bt_make_signature_type(context, bt_make_array_type(context, string), find_args, 2);
+	fn_ref = bt_make_native(context, module, split_sig, bt_string_split);
+
+	bt_type_add_field(context, string, split_sig, BT_VALUE_CSTRING(context, "split"), BT_VALUE_OBJECT(fn_ref));
+	bt_module_export(context, module, split_sig, BT_VALUE_CSTRING(context, "split"), BT_VALUE_OBJECT(fn_ref));
+
 	bt_Type* reverse_sig = bt_make_signature_type(context, string, &string, 1);
 	fn_ref = bt_make_native(context, module, reverse_sig, bt_string_reverse);
 
@@ -417,6 +814,50 @@ void boltstd_open_strings(bt_Context* context)
 	fn_ref = bt_make_native(context, module, compare_at_sig, bt_string_compare_at);
 	bt_type_add_field(context, string, compare_at_sig, BT_VALUE_CSTRING(context, "compare_at"), BT_VALUE_OBJECT(fn_ref));
 	bt_module_export(context, module, compare_at_sig, BT_VALUE_CSTRING(context, "compare_at"), BT_VALUE_OBJECT(fn_ref));
+
+	bt_Type* builder_type = bt_make_userdata_type(context, builder_type_name);
+	bt_userdata_type_set_finalizer(builder_type, btstr_builder_finalizer);
+
+	bt_module_export(context, module, bt_make_alias_type(context, builder_type_name, builder_type),
+		BT_VALUE_CSTRING(context, builder_type_name), bt_value((bt_Object*)builder_type));
+	bt_module_set_storage(module, BT_VALUE_CSTRING(context, builder_type_name), bt_value((bt_Object*)builder_type));
+
+	bt_module_export_native(context, module, "builder", btstr_builder, builder_type, NULL, 0);
+
+	bt_Type* format_cache_type = bt_make_userdata_type(context, format_cache_type_name);
+	bt_userdata_type_set_finalizer(format_cache_type, format_cache_finalizer);
+
+	btstr_FormatCache empty_cache;
+	memset(&empty_cache, 0, sizeof(btstr_FormatCache));
+	bt_Userdata* format_cache = bt_make_userdata(context, format_cache_type, &empty_cache, sizeof(btstr_FormatCache));
+	bt_push_root(context, (bt_Object*)format_cache);
+	bt_Array* format_cache_keys = bt_make_array(context, FORMAT_CACHE_SIZE + 1);
+	bt_array_resize(context, format_cache_keys, FORMAT_CACHE_SIZE, BT_VALUE_NULL);
+	bt_array_push(context, format_cache_keys, BT_VALUE_OBJECT(format_cache));
+	bt_pop_root(context);
+	bt_module_set_storage(module, BT_VALUE_CSTRING(context, format_cache_keys_name), bt_value((bt_Object*)format_cache_keys));
+
+	bt_Type* builder_append_args[] = { builder_type, any };
+	bt_Type* builder_append_sig = bt_make_signature_type(context, builder_type, builder_append_args, 2);
+	fn_ref = bt_make_native(context, module, builder_append_sig, btstr_builder_append);
+	bt_type_add_field(context, builder_type, builder_append_sig, BT_VALUE_CSTRING(context, "append"), BT_VALUE_OBJECT(fn_ref));
+
+	bt_Type* builder_reserve_args[] = { builder_type, number };
+	bt_Type* builder_reserve_sig = bt_make_signature_type(context, NULL, builder_reserve_args, 2);
+	fn_ref = bt_make_native(context, module, builder_reserve_sig, btstr_builder_reserve);
+	bt_type_add_field(context, builder_type, builder_reserve_sig, BT_VALUE_CSTRING(context, "reserve"), BT_VALUE_OBJECT(fn_ref));
+
+	bt_Type* builder_length_sig = bt_make_signature_type(context, number, &builder_type, 1);
+	fn_ref = bt_make_native(context, module, builder_length_sig, btstr_builder_length);
+	bt_type_add_field(context, builder_type, builder_length_sig, BT_VALUE_CSTRING(context, "length"), BT_VALUE_OBJECT(fn_ref));
+
+	bt_Type* builder_clear_sig = bt_make_signature_type(context, NULL, &builder_type, 1);
+	fn_ref = bt_make_native(context, module, builder_clear_sig, btstr_builder_clear);
+	bt_type_add_field(context, builder_type, builder_clear_sig, BT_VALUE_CSTRING(context, "clear"), BT_VALUE_OBJECT(fn_ref));
+
+	bt_Type* builder_to_string_sig = bt_make_signature_type(context, string, &builder_type, 1);
+	fn_ref = bt_make_native(context, module, builder_to_string_sig, btstr_builder_to_string);
+	bt_type_add_field(context, builder_type, builder_to_string_sig, BT_VALUE_CSTRING(context, "to_string"), BT_VALUE_OBJECT(fn_ref));
 	
 	bt_register_module(context, BT_VALUE_CSTRING(context, "strings"), module);
 }
\ No newline at end of file
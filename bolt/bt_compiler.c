@@ -15,6 +15,8 @@
 #include "bt_object.h"
 
 static const uint8_t INVALID_BINDING = 255;
+// The number of array literal elements evaluated into registers before they're appended in one go
+static const uint8_t ARRAY_LITERAL_CHUNK = 16;
 
 typedef struct Constant {
     bt_StrSlice name;
@@ -97,6 +99,12 @@ static uint8_t internal_ffsll(uint64_t mask)
     return bit;
 }
 
+static bt_bool is_buffer_type(bt_Type* type)
+{
+    type = bt_type_dealias(type);
+    return type && type->category == BT_TYPE_CATEGORY_USERDATA && type->as.userdata.is_buffer;
+}
+
 static void table_ensure_template_made(bt_Context* ctx, bt_Type* tblshp)
 {
     if (tblshp->as.table_shape.tmpl == 0)
@@ -156,6 +164,15 @@ static uint32_t emit_aibc(FunctionContext* ctx, bt_OpCode code, uint8_t a, int16
     return emit_op(ctx, op);
 }
 
+// Emits a constant-key index op, followed by an extension op holding the slot cache when enabled
+static uint32_t emit_idx_k(FunctionContext* ctx, bt_OpCode code, uint8_t a, uint8_t b, uint8_t c)
+{
+    bt_bool cached = ctx->compiler->options.cache_index_slots;
+    uint32_t result = emit_abc(ctx, code, a, b, c, cached);
+    if (cached) emit_aibc(ctx, BT_OP_IDX_EXT, 0, 0);
+    return result;
+}
+
 static uint32_t emit_ab(FunctionContext* ctx, bt_OpCode code, uint8_t a, uint8_t b, bt_bool is_accelerated)
 {
     return emit_abc(ctx, code, a, b, 0, is_accelerated);
@@ -719,7 +736,8 @@ static bt_bool compile_expression(FunctionContext* ctx, bt_AstNode* expr, uint8_
                     BT_VALUE_OBJECT(bt_make_string_hashed_len(ctx->context, rhs->source->source.source, rhs->source->source.length)));
                 bt_Value is_prototypical = get_from_proto(lhs->as.binary_op.from, lhs->as.binary_op.key);
 
-                emit_abc(ctx, (is_prototypical == BT_VALUE_NULL || !ctx->compiler->options.predict_hash_slots) ? BT_OP_LOAD_IDX_K : BT_OP_LOAD_PROTO, start_loc, obj_loc, idx, BT_FALSE);
+                if (is_prototypical == BT_VALUE_NULL || !ctx->compiler->options.predict_hash_slots) emit_idx_k(ctx, BT_OP_LOAD_IDX_K, start_loc, obj_loc, idx);
+                else emit_abc(ctx, BT_OP_LOAD_PROTO, start_loc, obj_loc, idx, BT_FALSE);
             }
         }
         else {
@@ -842,7 +860,7 @@ static bt_bool compile_expression(FunctionContext* ctx, bt_AstNode* expr, uint8_
                 goto try_store;
             }
             else if (expr->as.binary_op.accelerated && ctx->compiler->options.predict_hash_slots) {
-                if (expr->as.binary_op.left->resulting_type->category != BT_TYPE_CATEGORY_ARRAY) {
+                if (expr->as.binary_op.left->resulting_type->category != BT_TYPE_CATEGORY_ARRAY && !is_buffer_type(expr->as.binary_op.left->resulting_type)) {
                     uint8_t idx = push(ctx,
                         BT_VALUE_OBJECT(bt_make_string_hashed_len(ctx->context, rhs->source->source.source, rhs->source->source.length)));
                     
@@ -856,7 +874,8 @@ static bt_bool compile_expression(FunctionContext* ctx, bt_AstNode* expr, uint8_
                     BT_VALUE_OBJECT(bt_make_string_hashed_len(ctx->context, rhs->source->source.source, rhs->source->source.length)));
 
                 bt_Value is_prototypical = get_from_proto(expr->as.binary_op.from, expr->as.binary_op.key);
-                emit_abc(ctx, (is_prototypical == BT_VALUE_NULL || !ctx->compiler->options.predict_hash_slots) ? BT_OP_LOAD_IDX_K : BT_OP_LOAD_PROTO, result_loc, lhs_loc, idx, BT_FALSE);
+                if (is_prototypical == BT_VALUE_NULL || !ctx->compiler->options.predict_hash_slots) emit_idx_k(ctx, BT_OP_LOAD_IDX_K, result_loc, lhs_loc, idx);
+                else emit_abc(ctx, BT_OP_LOAD_PROTO, result_loc, lhs_loc, idx, BT_FALSE);
 
                 goto try_store;
             }
@@ -921,6 +940,9 @@ static bt_bool compile_expression(FunctionContext* ctx, bt_AstNode* expr, uint8_
         case BT_TOKEN_PERIOD:
             if (expr->as.binary_op.accelerated && expr->as.binary_op.left->resulting_type->category == BT_TYPE_CATEGORY_ARRAY && ctx->compiler->options.typed_array_subscript) {
                 emit_abc(ctx, BT_OP_LOAD_SUB_F, result_loc, lhs_loc, rhs_loc, BT_FALSE);
+            }
+            else if (expr->as.binary_op.accelerated && is_buffer_type(expr->as.binary_op.left->resulting_type) && ctx->compiler->options.typed_array_subscript) {
+                emit_abc(ctx, BT_OP_LOAD_BUF_F, result_loc, lhs_loc, rhs_loc, BT_FALSE);
             } else emit_abc(ctx, BT_OP_LOAD_IDX, result_loc, lhs_loc, rhs_loc, BT_FALSE);
             break;
         case BT_TOKEN_EQUALS:
@@ -978,6 +1000,12 @@ static bt_bool compile_expression(FunctionContext* ctx, bt_AstNode* expr, uint8_
                     uint8_t idx_loc = find_binding_or_compile_temp(ctx, lhs->as.binary_op.right);
                     emit_abc(ctx, BT_OP_STORE_SUB_F, tbl_loc, idx_loc, result_loc, BT_FALSE);
                 }
+                else if (is_buffer_type(lhs->as.binary_op.left->resulting_type)) {
+                    if (!ctx->compiler->options.typed_array_subscript) goto failed_array;
+
+                    uint8_t idx_loc = find_binding_or_compile_temp(ctx, lhs->as.binary_op.right);
+                    emit_abc(ctx, BT_OP_STORE_BUF_F, tbl_loc, idx_loc, result_loc, BT_FALSE);
+                }
                 else if (ctx->compiler->options.predict_hash_slots)
                 {
                     bt_Token* source = lhs->as.binary_op.right->source;
@@ -996,7 +1024,7 @@ static bt_bool compile_expression(FunctionContext* ctx, bt_AstNode* expr, uint8_
                 bt_Token* source = lhs->as.binary_op.right->source;
                 uint8_t idx = push(ctx,
                     BT_VALUE_OBJECT(bt_make_string_hashed_len(ctx->context, source->source.source, source->source.length)));
-                emit_abc(ctx, BT_OP_STORE_IDX_K, tbl_loc, idx, result_loc, BT_FALSE);
+                emit_idx_k(ctx, BT_OP_STORE_IDX_K, tbl_loc, idx, result_loc);
                 goto stored_fast;
             }
 
@@ -1051,7 +1079,7 @@ static bt_bool compile_expression(FunctionContext* ctx, bt_AstNode* expr, uint8_
 
             if (expr->as.table.typed && ctx->compiler->options.predict_hash_slots && expr->resulting_type->as.table_shape.sealed) {
                 bt_Table* layout = resulting->as.table_shape.layout;
-                int16_t idx = bt_table_get_idx(layout, entry->as.table_field.key);
+                int32_t idx = bt_table_get_idx(layout, entry->as.table_field.key);
                 uint8_t key_idx = push(ctx, entry->as.table_field.key);
 
                 // If index is too large for acceleration, or part of an unsealed table, fallback to the slow method
@@ -1073,29 +1101,26 @@ static bt_bool compile_expression(FunctionContext* ctx, bt_AstNode* expr, uint8_
     case BT_AST_NODE_ARRAY: {
         push_registers(ctx);
         bt_AstBuffer* items = &expr->as.arr.items;
-        emit_aibc(ctx, BT_OP_ARRAY, result_loc, items->length);
-
-        uint8_t idx_loc = get_register(ctx);
-        uint8_t val_loc = get_register(ctx);
-        
-        uint8_t one_loc;
-        if (items->length >= INT16_MAX) {
-            one_loc = get_register(ctx);
-            emit_aibc(ctx, BT_OP_LOAD_SMALL, one_loc, 1);
+        // The array is allocated at its final size up front, any elements past INT16_MAX just grow it once more
+        emit_aibc(ctx, BT_OP_ARRAY, result_loc, items->length < INT16_MAX ? items->length : INT16_MAX);
+
+        // Elements are evaluated into a run of consecutive registers, and appended a whole run at a time
+        uint8_t chunk_size = items->length < ARRAY_LITERAL_CHUNK ? (uint8_t)items->length : ARRAY_LITERAL_CHUNK;
+        uint8_t chunk_loc = chunk_size ? get_registers(ctx, chunk_size) : 0;
+        if (chunk_loc == UINT8_MAX) {
+            compile_error_token(ctx->compiler, "Ran out of registers for array literal '%.*s'", expr->source);
+            restore_registers(ctx);
+            return BT_FALSE;
         }
 
-        for (uint32_t i = 0; i < items->length; ++i) {
-            bt_AstNode* entry = items->elements[i];
+        for (uint32_t i = 0; i < items->length; i += chunk_size) {
+            uint8_t count = items->length - i < chunk_size ? (uint8_t)(items->length - i) : chunk_size;
 
-            if (i < INT16_MAX) {
-                emit_aibc(ctx, BT_OP_LOAD_SMALL, idx_loc, i);
-            }
-            else {
-                emit_abc(ctx, BT_OP_ADD, idx_loc, idx_loc, one_loc, ctx->compiler->options.accelerate_arithmetic);
+            for (uint8_t j = 0; j < count; ++j) {
+                compile_expression(ctx, items->elements[i + j], chunk_loc + j);
             }
-            compile_expression(ctx, entry, val_loc);
 
-            emit_abc(ctx, BT_OP_STORE_IDX, result_loc, idx_loc, val_loc, BT_FALSE);
+            emit_abc(ctx, BT_OP_APPEND_N, result_loc, chunk_loc, count, BT_FALSE);
         }
         restore_registers(ctx);
     } break;
@@ -20,8 +20,10 @@ typedef struct bt_CompilerOptions {
 	bt_bool allow_method_hoisting;
 	/** If enabled, the compiler will generate faster versions of table indexing opcodes whenever the slot can be predicted */
 	bt_bool predict_hash_slots;
-	/** If enabled, the compiler will generate accelerated opcodes for array indexing whenever the type information allows */
+	/** If enabled, the compiler will generate accelerated opcodes for array and typed buffer indexing whenever the type information allows */
 	bt_bool typed_array_subscript;
+	/** If enabled, indexing with a constant key remembers the slot it last found the key at, speeding up tables that weren't built from a sealed tableshape */
+	bt_bool cache_index_slots;
 } bt_CompilerOptions;
 
 typedef struct bt_Compiler {
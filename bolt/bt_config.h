@@ -26,6 +26,10 @@
 // Also takes significantly longer to compile.
 #define BOLT_USE_INLINE_THREADING
 
+// Allows hot scans (like small table key lookups) to use SSE2 intrinsics on x86-64
+// Other architectures, or builds with this disabled, fall back to equivalent scalar loops
+#define BOLT_USE_SIMD
+
 // Allows for the use of the cstdlib to set up some reasonable default handlers for memory allocation
 #define BOLT_ALLOW_MALLOC
 
@@ -35,6 +39,10 @@
 // Allows for the use of the cstdlib to set up default module loaders
 #define BOLT_ALLOW_FOPEN
 
+// Allows for the use of the cstdlib clock to time garbage collection pauses
+// Without it, pause times in the gc statistics are always reported as zero
+#define BOLT_ALLOW_CLOCK
+
 // Builds bolt as a shared library as opposed to statically linking
 // Make sure BOLT_EXPORT_SHARED is defined when building the library
 //#define BOLT_SHARED_LIBRARY
@@ -60,16 +68,28 @@
 #define BT_CALLSTACK_SIZE 128
 #endif
 
-// The number of root entries in the string deduplication table
-// 126 is tuned to cover the standard ascii charset 
+// The initial number of slots in the string deduplication table, must be a power of two
+// The table doubles in size whenever it becomes half full
 #ifndef BT_STRINGTABLE_SIZE
-#define BT_STRINGTABLE_SIZE 126
+#define BT_STRINGTABLE_SIZE 256
 #endif
 
 // The maximum length of a string that is considered for interning
-// Longer values may compromise runtime performance due to excess hashing
+// Hashing takes 8 bytes at a time, so this mostly trades the memory held by the intern table against cheaper equality checks
 #ifndef BT_STRINGTABLE_MAX_LEN
-#define BT_STRINGTABLE_MAX_LEN 24
+#define BT_STRINGTABLE_MAX_LEN 32
+#endif
+
+// The number of non-negative integers, starting from 0, whose string forms are cached by the context when first converted
+// Along with `true`, `false` and `null`, converting these to strings never allocates after the first time
+#ifndef BT_SMALL_INT_STRINGS
+#define BT_SMALL_INT_STRINGS 1024
+#endif
+
+// The minimum length of a substring for it to reference its parent's character data instead of copying it
+// Shorter substrings are cheaper to copy (and intern) than to keep the whole parent alive for
+#ifndef BT_STRING_SLICE_MIN_LEN
+#define BT_STRING_SLICE_MIN_LEN 64
 #endif
 
 // The size of the temporary root stack kept by the bolt context
@@ -86,4 +106,25 @@
 // The stack size for the temporary string that bt_to_string uses during conversion
 #ifndef BT_TO_STRING_BUF_LENGTH
 #define BT_TO_STRING_BUF_LENGTH 1024
+#endif
+
+// The number of recent gc pause times kept around for computing percentiles
+#ifndef BT_GC_PAUSE_HISTORY_SIZE
+#define BT_GC_PAUSE_HISTORY_SIZE 64
+#endif
+
+// The minimum size of each block of memory allocated for the arena, later blocks grow geometrically
+#ifndef BT_ARENA_CHUNK_SIZE
+#define BT_ARENA_CHUNK_SIZE (64 * 1024)
+#endif
+
+// The number of entries in the per-context cache of prototype lookups, must be a power of two
+#ifndef BT_PROTO_CACHE_SIZE
+#define BT_PROTO_CACHE_SIZE 256
+#endif
+
+// The pair capacity at which a table starts keeping a hash index next to its pairs
+// Below this, scanning the pairs linearly is faster than hashing the key
+#ifndef BT_TABLE_INDEX_THRESHOLD
+#define BT_TABLE_INDEX_THRESHOLD 32
 #endif
\ No newline at end of file
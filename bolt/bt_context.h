@@ -19,18 +19,38 @@ typedef void* (*bt_Alloc)(size_t size);
 typedef void* (*bt_Realloc)(void* ptr, size_t size);
 typedef void (*bt_Free)(void* ptr);
 
+typedef void* (*bt_AllocatorAlloc)(void* userdata, size_t size);
+typedef void* (*bt_AllocatorRealloc)(void* userdata, void* ptr, size_t old_size, size_t new_size);
+typedef void (*bt_AllocatorFree)(void* userdata, void* ptr, size_t size);
+
+/** Allocator interface with a user pointer passed to every call, along with the size of the block when resizing or freeing it */
+typedef struct bt_Allocator {
+	bt_AllocatorAlloc alloc;
+	bt_AllocatorRealloc realloc;
+	bt_AllocatorFree free;
+	void* userdata;
+} bt_Allocator;
+
 typedef char* (*bt_ReadFile)(bt_Context* ctx, const char* path, void** out_handle);
 typedef void (*bt_CloseFile)(bt_Context* ctx, const char* path, void*  in_handle);
 typedef void (*bt_FreeSource)(bt_Context* ctx, char* source);
 typedef void (*bt_Write)(bt_Context* ctx, const char* msg);
 
-/** An entry into the string deduplication table */
+/** An entry into the string deduplication table, `string` is NULL for empty slots */
 typedef struct bt_StringTableEntry {
 	uint64_t hash;
 	bt_String* string;
 } bt_StringTableEntry;
 
-typedef bt_Buffer(bt_StringTableEntry) bt_StringTableBucket;
+/** 
+ * The string deduplication table, open addressed with linear probing.
+ * `capacity` is always a power of two, and the table doubles whenever it becomes half full
+ */
+typedef struct bt_StringTable {
+	bt_StringTableEntry* entries;
+	uint32_t capacity;
+	uint32_t count;
+} bt_StringTable;
 
 /** Error category passed to the callback provided in the handlers */
 typedef enum {
@@ -68,11 +88,20 @@ typedef struct bt_Path {
 	struct bt_Path* next;
 } bt_Path;
 
+/** Remembers which table along the prototype chain starting at `proto` held `key`, and at what slot. Only valid while `epoch` matches the context's */
+typedef struct bt_ProtoCacheEntry {
+	bt_Table* proto;
+	bt_Table* holder;
+	bt_Value key;
+	uint32_t slot, epoch;
+} bt_ProtoCacheEntry;
+
 /**
  * Set of callback functions expected to be set up for the bolt context to function properly
  * alloc - general purpose allocator
  * free - matching free
  * realloc - matching realloc
+ * allocator - optional sized allocator with a user pointer, used instead of the above when `allocator.alloc` is set
  *
  * on_error - callback for whenever the parser, compiler, or runtime encounters an error
  *
@@ -86,6 +115,7 @@ typedef struct bt_Handlers {
 	bt_Alloc alloc;
 	bt_Free free;
 	bt_Realloc realloc;
+	bt_Allocator allocator;
 	bt_ErrorFunc on_error;
 
 	bt_Write write;
@@ -106,6 +136,7 @@ struct bt_Context {
 	bt_Alloc alloc;
 	bt_Free free;
 	bt_Realloc realloc;
+	bt_Allocator allocator;
 	bt_ErrorFunc on_error;
 
 	bt_Write write;
@@ -124,7 +155,18 @@ struct bt_Context {
 
 	bt_Path* module_paths;
 
-	bt_StringTableBucket string_table[BT_STRINGTABLE_SIZE];
+	bt_StringTable string_table;
+	// Every single byte string and the empty string, interned on first use and then kept alive for the lifetime of the context
+	bt_String* byte_strings[256];
+	bt_String* empty_string;
+	// String forms of small integers and the literal values, see `bt_to_common_string`
+	bt_String* small_int_strings[BT_SMALL_INT_STRINGS];
+	bt_String* true_string;
+	bt_String* false_string;
+	bt_String* null_string;
+
+	bt_ProtoCacheEntry proto_cache[BT_PROTO_CACHE_SIZE];
+	uint32_t proto_cache_epoch;
 
 	struct {
 		bt_Type* any;
@@ -174,6 +216,7 @@ typedef struct bt_Thread {
 
 	bt_Context* context;
 	bt_Op* ip;
+	struct bt_Thread* parent;
 	
 	bt_bool should_report;
 } bt_Thread;
@@ -189,6 +232,8 @@ BOLT_API void bt_register_prelude(bt_Context* context, bt_Value name, bt_Type* t
 BOLT_API void bt_register_module(bt_Context* context, bt_Value name, bt_Module* module);
 /** Search the module registry by name, returning NULL if no module is found. If `suppress_errors` is set, no runtime errors are raised */
 BOLT_API bt_Module* bt_find_module(bt_Context* context, bt_Value name, bt_bool suppress_errors);
+/** Search only the modules registered or already loaded under `name`, returning NULL rather than loading one from the module paths */
+BOLT_API bt_Module* bt_find_registered_module(bt_Context* context, bt_Value name);
 
 /** Allocates a new thread with an empty callstack */
 BOLT_API bt_Thread* bt_make_thread(bt_Context* context);
@@ -235,6 +280,8 @@ BOLT_API uint32_t bt_get_debug_index(bt_Callable* callable, bt_Op* ip);
 BOLT_API bt_String* bt_get_or_make_interned(bt_Context* ctx, const char* str, uint32_t len);
 /** Evict a string from the deduplication table */
 BOLT_API void bt_remove_interned(bt_Context* ctx, bt_String* str);
+/** Evict every string that wasn't marked by the current gc cycle from the deduplication table */
+BOLT_API void bt_purge_interned(bt_Context* ctx);
 
 #if __cplusplus
 }
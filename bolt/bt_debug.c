@@ -2,8 +2,11 @@
 
 #include "bt_value.h"
 #include "bt_gc.h"
+#include "bt_type.h"
+#include "bt_context.h"
 
 #include <stdio.h>
+#include <string.h>
 
 static const char* ast_node_type_to_string(bt_AstNode* node)
 {
@@ -159,7 +162,9 @@ static bt_bool is_op_abc(uint8_t op) {
 	case BT_OP_COALESCE: case BT_OP_TCHECK:
 	case BT_OP_TCAST: case BT_OP_TSET:
 	case BT_OP_CALL: case BT_OP_REC_CALL:
+	case BT_OP_APPEND_N:
 	case BT_OP_LOAD_SUB_F: case BT_OP_STORE_SUB_F:
+	case BT_OP_LOAD_BUF_F: case BT_OP_STORE_BUF_F:
 		return BT_TRUE;
 	default:
 		return BT_FALSE;
@@ -337,3 +342,210 @@ bt_String* bt_debug_dump_fn(bt_Context* ctx, bt_Callable* function)
 
 	return result;
 }
+
+#define SNAPSHOT_BUFFER_SIZE 4096
+#define SNAPSHOT_LABEL_LENGTH 48
+
+typedef struct bt_SnapshotState {
+	bt_Context* ctx;
+	bt_SnapshotWriter writer;
+	void* userdata;
+
+	bt_Object** pending;
+	uint32_t pending_count, pending_cap;
+
+	bt_bool first_entry, first_ref;
+	uint32_t length;
+	char buffer[SNAPSHOT_BUFFER_SIZE];
+} bt_SnapshotState;
+
+static void snapshot_flush(bt_SnapshotState* state)
+{
+	if (state->length) state->writer(state->userdata, state->buffer, state->length);
+	state->length = 0;
+}
+
+static void snapshot_write(bt_SnapshotState* state, const char* data, size_t length)
+{
+	while (length) {
+		size_t space = SNAPSHOT_BUFFER_SIZE - state->length;
+		size_t chunk = length < space ? length : space;
+		memcpy(state->buffer + state->length, data, chunk);
+		state->length += (uint32_t)chunk;
+		data += chunk;
+		length -= chunk;
+
+		if (state->length == SNAPSHOT_BUFFER_SIZE) snapshot_flush(state);
+	}
+}
+
+static void snapshot_write_cstr(bt_SnapshotState* state, const char* str)
+{
+	snapshot_write(state, str, strlen(str));
+}
+
+static void snapshot_write_id(bt_SnapshotState* state, bt_Object* obj)
+{
+	char buffer[32];
+	int32_t length = sprintf(buffer, "%llu", (unsigned long long)(uintptr_t)obj);
+	snapshot_write(state, buffer, length);
+}
+
+/** Writes a quoted json string, truncated to a label-friendly length */
+static void snapshot_write_label(bt_SnapshotState* state, const char* str, size_t length)
+{
+	if (length > SNAPSHOT_LABEL_LENGTH) length = SNAPSHOT_LABEL_LENGTH;
+
+	snapshot_write(state, "\"", 1);
+	for (size_t i = 0; i < length; ++i) {
+		unsigned char c = (unsigned char)str[i];
+		if (c == '"' || c == '\\') {
+			char escaped[2] = { '\\', (char)c };
+			snapshot_write(state, escaped, 2);
+		}
+		else if (c < 0x20 || c >= 0x7f) {
+			char escaped[8];
+			sprintf(escaped, "\\u%04x", c);
+			snapshot_write(state, escaped, 6);
+		}
+		else {
+			snapshot_write(state, (const char*)&c, 1);
+		}
+	}
+	snapshot_write(state, "\"", 1);
+}
+
+static void snapshot_write_string_label(bt_SnapshotState* state, bt_String* str)
+{
+	if (str) snapshot_write_label(state, BT_STRING_STR(str), str->len);
+	else snapshot_write_label(state, "", 0);
+}
+
+static void snapshot_write_type_label(bt_SnapshotState* state, bt_Type* type)
+{
+	const char* name = type && type->name ? type->name : "";
+	snapshot_write_label(state, name, strlen(name));
+}
+
+static void snapshot_push(bt_SnapshotState* state, bt_Object* obj)
+{
+	if (BT_OBJECT_GET_MARK(obj)) return;
+	BT_OBJECT_MARK(obj);
+
+	if (state->pending_count == state->pending_cap) {
+		uint32_t new_cap = state->pending_cap ? state->pending_cap * 2 : 256;
+		state->pending = bt_gc_realloc(state->ctx, state->pending, state->pending_cap * sizeof(bt_Object*), new_cap * sizeof(bt_Object*));
+		state->pending_cap = new_cap;
+	}
+
+	state->pending[state->pending_count++] = obj;
+}
+
+static void snapshot_root(bt_Object* obj, const char* name, void* userdata)
+{
+	bt_SnapshotState* state = (bt_SnapshotState*)userdata;
+
+	snapshot_write_cstr(state, state->first_entry ? "\n[" : ",\n[");
+	state->first_entry = BT_FALSE;
+	snapshot_write_id(state, obj);
+	snapshot_write(state, ",", 1);
+	snapshot_write_label(state, name, strlen(name));
+	snapshot_write(state, "]", 1);
+
+	snapshot_push(state, obj);
+}
+
+static void snapshot_reference(bt_Object* obj, void* userdata)
+{
+	bt_SnapshotState* state = (bt_SnapshotState*)userdata;
+
+	if (!state->first_ref) snapshot_write(state, ",", 1);
+	state->first_ref = BT_FALSE;
+	snapshot_write_id(state, obj);
+
+	snapshot_push(state, obj);
+}
+
+static void snapshot_node(bt_SnapshotState* state, bt_Object* obj)
+{
+	char buffer[64];
+	bt_ObjectType type = BT_OBJECT_GET_TYPE(obj);
+
+	snapshot_write_cstr(state, state->first_entry ? "\n[" : ",\n[");
+	state->first_entry = BT_FALSE;
+	snapshot_write_id(state, obj);
+	snapshot_write(state, ",\"", 2);
+	snapshot_write_cstr(state, bt_gc_object_type_name(type));
+	int32_t length = sprintf(buffer, "\",%llu,", (unsigned long long)bt_gc_get_object_footprint(obj));
+	snapshot_write(state, buffer, length);
+
+	switch (type) {
+	case BT_OBJECT_TYPE_TYPE: snapshot_write_type_label(state, (bt_Type*)obj); break;
+	case BT_OBJECT_TYPE_STRING: snapshot_write_string_label(state, (bt_String*)obj); break;
+	case BT_OBJECT_TYPE_MODULE: {
+		bt_Module* mod = (bt_Module*)obj;
+		snapshot_write_string_label(state, mod->name ? mod->name : mod->path);
+	} break;
+	case BT_OBJECT_TYPE_IMPORT: snapshot_write_string_label(state, ((bt_ModuleImport*)obj)->name); break;
+	case BT_OBJECT_TYPE_FN: snapshot_write_type_label(state, ((bt_Fn*)obj)->signature); break;
+	case BT_OBJECT_TYPE_NATIVE_FN: snapshot_write_type_label(state, ((bt_NativeFn*)obj)->type); break;
+	case BT_OBJECT_TYPE_CLOSURE: {
+		// Closures can also wrap native functions, such as the iterators returned by the standard library
+		bt_Object* fn = (bt_Object*)((bt_Closure*)obj)->fn;
+		bt_Type* signature = BT_OBJECT_GET_TYPE(fn) == BT_OBJECT_TYPE_FN ? ((bt_Fn*)fn)->signature : ((bt_NativeFn*)fn)->type;
+		snapshot_write_type_label(state, signature);
+	} break;
+	case BT_OBJECT_TYPE_USERDATA: snapshot_write_type_label(state, ((bt_Userdata*)obj)->type); break;
+	case BT_OBJECT_TYPE_ANNOTATION: snapshot_write_string_label(state, ((bt_Annotation*)obj)->name); break;
+	case BT_OBJECT_TYPE_ARRAY: {
+		length = sprintf(buffer, "[%u]", (uint32_t)bt_array_length((bt_Array*)obj));
+		snapshot_write_label(state, buffer, length);
+	} break;
+	case BT_OBJECT_TYPE_TABLE: {
+		length = sprintf(buffer, "{%u}", BT_TABLE_LENGTH(obj));
+		snapshot_write_label(state, buffer, length);
+	} break;
+	default: snapshot_write_label(state, "", 0); break;
+	}
+
+	snapshot_write(state, ",[", 2);
+	state->first_ref = BT_TRUE;
+	bt_gc_visit_references(obj, snapshot_reference, state);
+	snapshot_write(state, "]]", 2);
+}
+
+void bt_heap_snapshot(bt_Context* ctx, bt_SnapshotWriter writer, void* userdata)
+{
+	// Marks are borrowed to track visited objects, so they all have to start out clear
+	bt_gc_finish_sweep(ctx);
+	bt_gc_pause(ctx);
+
+	bt_SnapshotState state;
+	state.ctx = ctx;
+	state.writer = writer;
+	state.userdata = userdata;
+	state.pending = NULL;
+	state.pending_count = state.pending_cap = 0;
+	state.length = 0;
+
+	snapshot_write_cstr(&state, "{\"format\":\"bolt-heap\",\"version\":1,\"roots\":[");
+	state.first_entry = BT_TRUE;
+	bt_gc_visit_roots(ctx, snapshot_root, &state);
+
+	snapshot_write_cstr(&state, "\n],\"nodes\":[");
+	state.first_entry = BT_TRUE;
+	while (state.pending_count) {
+		snapshot_node(&state, state.pending[--state.pending_count]);
+	}
+
+	snapshot_write_cstr(&state, "\n]}\n");
+	snapshot_flush(&state);
+
+	if (state.pending) bt_gc_free(ctx, state.pending, state.pending_cap * sizeof(bt_Object*));
+
+	for (bt_Object* obj = ctx->root; obj; obj = (bt_Object*)BT_OBJECT_NEXT(obj)) {
+		BT_OBJECT_CLEAR(obj);
+	}
+
+	bt_gc_unpause(ctx);
+}
@@ -20,6 +20,18 @@ BOLT_API void bt_debug_print_parse_tree(bt_Parser* parser);
  */
 BOLT_API bt_String* bt_debug_dump_fn(bt_Context* ctx, bt_Callable* function);
 
+/** Receives successive chunks of output from `bt_heap_snapshot` */
+typedef void (*bt_SnapshotWriter)(void* userdata, const char* data, size_t length);
+
+/**
+ * Writes a JSON graph of every object reachable from the gc roots to `writer`.
+ * Each node records the object's type, its footprint in bytes, a short label and the objects it references.
+ * Roots are listed separately, named after where they are held from (stack, native_references, ...).
+ * Finishes any pending sweep first, and must not be called while the gc is mid-collection.
+ * `writer` must not allocate managed objects. The output can be analyzed offline with the `bolt-heap` tool.
+ */
+BOLT_API void bt_heap_snapshot(bt_Context* ctx, bt_SnapshotWriter writer, void* userdata);
+
 #if __cplusplus
 }
 #endif
\ No newline at end of file
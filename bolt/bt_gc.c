@@ -6,53 +6,221 @@
 
 #include <string.h>
 
+#ifdef BOLT_ALLOW_CLOCK
+#include <time.h>
+#endif
+
 #include "bt_type.h"
 #include "bt_context.h"
 #include "bt_compiler.h"
 #include "bt_userdata.h"
 
-void* bt_gc_alloc(bt_Context* ctx, size_t size)
+/** Monotonic timestamp in nanoseconds, used to measure gc pauses */
+static uint64_t get_timestamp()
+{
+#ifdef BOLT_ALLOW_CLOCK
+	struct timespec ts;
+#ifdef _MSC_VER
+	timespec_get(&ts, TIME_UTC);
+#else
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+	return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#else
+	return 0;
+#endif
+}
+
+#define ARENA_ALIGNMENT 16
+#define ARENA_CHUNK_DATA(chunk) ((char*)((chunk) + 1))
+
+/** Bump allocate `size` bytes from the arena, moving on to a retained or freshly allocated chunk when the current one is full */
+static void* arena_alloc(bt_Context* ctx, size_t size)
+{
+	bt_GC* gc = &ctx->gc;
+	size = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+
+	bt_ArenaChunk* chunk = gc->arena_current;
+	if (!chunk || chunk->used + size > chunk->size) {
+		bt_ArenaChunk** link = chunk ? &chunk->next : &gc->arena_chunks;
+		bt_ArenaChunk* next = *link;
+
+		// Chunks left over from earlier resets are reused when big enough, otherwise a new one is slotted in ahead of them
+		if (!next || next->size < size) {
+			size_t chunk_size = chunk ? chunk->size * 2 : BT_ARENA_CHUNK_SIZE;
+			if (chunk_size < size) chunk_size = size;
+
+			bt_ArenaChunk* new_chunk = ctx->allocator.alloc(ctx->allocator.userdata, sizeof(bt_ArenaChunk) + chunk_size);
+			new_chunk->size = chunk_size;
+			new_chunk->next = next;
+			*link = new_chunk;
+			next = new_chunk;
+		}
+
+		next->used = 0;
+		gc->arena_current = chunk = next;
+	}
+
+	void* result = ARENA_CHUNK_DATA(chunk) + chunk->used;
+	chunk->used += size;
+	return result;
+}
+
+bt_bool bt_arena_owns(bt_Context* ctx, void* ptr)
 {
-	ctx->gc.bytes_allocated += size;
-	void* ptr = ctx->alloc(size);
+	bt_GC* gc = &ctx->gc;
+	if (!gc->arena_current) return BT_FALSE;
+
+	for (bt_ArenaChunk* chunk = gc->arena_chunks; chunk; chunk = chunk->next) {
+		char* data = ARENA_CHUNK_DATA(chunk);
+		if ((char*)ptr >= data && (char*)ptr < data + chunk->used) return BT_TRUE;
+		if (chunk == gc->arena_current) break;
+	}
+
+	return BT_FALSE;
+}
+
+/** Raise a runtime error on the executing thread. Allocations made by the host outside of execution, or by the collector itself, are let through */
+static void memory_limit_exceeded(bt_Context* ctx)
+{
+	bt_GC* gc = &ctx->gc;
+	if (!ctx->current_thread || gc->in_collect) return;
+
+	// Paused sections like module compilation have no landing pad to unpause and release their state, and can't collect
+	// to make room either, so the error is deferred to the first allocation after the pause ends. Arenas hold a pause for
+	// their whole lifetime and are unwound by the host's reset, so they don't count
+	if (gc->pause_count > (gc->arena_depth ? 1u : 0u)) return;
+
+	// Lift the limit until the error is caught, as raising it allocates too
+	gc->limit_exceeded = BT_TRUE;
+	bt_runtime_error(ctx->current_thread, "Memory limit exceeded!", 0);
+}
+
+static void* heap_alloc(bt_Context* ctx, size_t size)
+{
+	bt_GC* gc = &ctx->gc;
+	if (gc->memory_limit && !gc->limit_exceeded && gc->bytes_allocated + size > gc->memory_limit) {
+		memory_limit_exceeded(ctx);
+	}
+
+	gc->bytes_allocated += size;
+	void* ptr = ctx->allocator.alloc(ctx->allocator.userdata, size);
 	return ptr;
 }
 
-void* bt_gc_realloc(bt_Context* ctx, void* ptr, size_t old_size, size_t new_size)
+static void* heap_realloc(bt_Context* ctx, void* ptr, size_t old_size, size_t new_size)
 {
 	if (old_size > ctx->gc.bytes_allocated) {
 		bt_runtime_error(ctx->current_thread, "Attempted to realloc more bytes than GC is tracking!", 0);
 		return NULL;
 	}
 
-	ctx->gc.bytes_allocated -= old_size;
-	void* new_ptr = ctx->realloc(ptr, new_size);
-	ctx->gc.bytes_allocated += new_size;
+	bt_GC* gc = &ctx->gc;
+	if (gc->memory_limit && !gc->limit_exceeded && new_size > old_size && gc->bytes_allocated + (new_size - old_size) > gc->memory_limit) {
+		memory_limit_exceeded(ctx);
+	}
+
+	gc->bytes_allocated -= old_size;
+	void* new_ptr = ptr ? ctx->allocator.realloc(ctx->allocator.userdata, ptr, old_size, new_size) : ctx->allocator.alloc(ctx->allocator.userdata, new_size);
+	gc->bytes_allocated += new_size;
+
+	return new_ptr;
+}
 
+/** Arena allocations can't grow in place, so they're copied into a new block and the old one is left for the reset */
+static void* arena_realloc(bt_Context* ctx, void* ptr, size_t old_size, size_t new_size)
+{
+	void* new_ptr = arena_alloc(ctx, new_size);
+	if (ptr) memcpy(new_ptr, ptr, old_size < new_size ? old_size : new_size);
 	return new_ptr;
 }
 
+void* bt_gc_alloc(bt_Context* ctx, size_t size)
+{
+	ctx->gc.stats.total_bytes_allocated += size;
+	if (ctx->gc.arena_depth) return arena_alloc(ctx, size);
+	return heap_alloc(ctx, size);
+}
+
+void* bt_gc_realloc(bt_Context* ctx, void* ptr, size_t old_size, size_t new_size)
+{
+	if (new_size > old_size) ctx->gc.stats.total_bytes_allocated += new_size - old_size;
+
+	if (ctx->gc.arena_depth && (!ptr || bt_arena_owns(ctx, ptr))) {
+		return arena_realloc(ctx, ptr, old_size, new_size);
+	}
+
+	return heap_realloc(ctx, ptr, old_size, new_size);
+}
+
 void bt_gc_free(bt_Context* ctx, void* ptr, size_t size)
 {
+	// Arena memory is only ever released by bt_arena_reset
+	if (ctx->gc.arena_depth && bt_arena_owns(ctx, ptr)) return;
+
 	if (size > ctx->gc.bytes_allocated) {
 		bt_runtime_error(ctx->current_thread, "Attempted to free more bytes than GC is tracking!", 0);
 		return;
 	}
 
 	ctx->gc.bytes_allocated -= size;
-	ctx->free(ptr);
+	if (ptr) ctx->allocator.free(ctx->allocator.userdata, ptr, size);
+}
+
+void* bt_gc_alloc_owned(bt_Context* ctx, bt_Object* owner, size_t size)
+{
+	if (ctx->gc.arena_depth && !bt_arena_owns(ctx, owner)) {
+		ctx->gc.stats.total_bytes_allocated += size;
+		return heap_alloc(ctx, size);
+	}
+
+	return bt_gc_alloc(ctx, size);
 }
 
+void* bt_gc_realloc_owned(bt_Context* ctx, bt_Object* owner, void* ptr, size_t old_size, size_t new_size)
+{
+	if (ctx->gc.arena_depth && !ptr && !bt_arena_owns(ctx, owner)) {
+		ctx->gc.stats.total_bytes_allocated += new_size;
+		return heap_realloc(ctx, ptr, old_size, new_size);
+	}
+
+	return bt_gc_realloc(ctx, ptr, old_size, new_size);
+}
+
+static uint32_t sweep(bt_GC* gc, uint32_t max_visit);
+static void record_pause(bt_GC* gc);
+
 bt_Object* bt_allocate(bt_Context* context, uint32_t full_size, bt_ObjectType type)
 {
-	if (context->gc.bytes_allocated >= context->gc.next_cycle) {
+	if (context->gc.sweep_cursor) {
+		sweep(&context->gc, context->gc.sweep_step);
+	}
+	else if (context->gc.bytes_allocated >= context->gc.next_cycle) {
+		bt_collect(&context->gc, 0);
+	}
+
+	// Give the collector a chance to make room before the memory limit is enforced
+	if (context->gc.memory_limit && context->gc.bytes_allocated + full_size > context->gc.memory_limit && !context->gc.limit_exceeded) {
 		bt_collect(&context->gc, 0);
+		bt_gc_finish_sweep(context);
 	}
 	
 	bt_Object* obj = bt_gc_alloc(context, full_size);
 	memset(obj, 0, full_size);
+	context->gc.stats.total_objects_allocated++;
 
 	BT_OBJECT_SET_TYPE(obj, type);
+
+	// Objects created while a sweep is pending are live by definition, mark them so the cursor skips them
+	if (context->gc.sweep_cursor) BT_OBJECT_MARK(obj);
+
+	if (context->gc.arena_depth && type == BT_OBJECT_TYPE_USERDATA) {
+		bt_ArenaFinalizer* finalizer = arena_alloc(context, sizeof(bt_ArenaFinalizer));
+		finalizer->obj = obj;
+		finalizer->next = context->gc.arena_finalizers;
+		context->gc.arena_finalizers = finalizer;
+	}
+
 	if (context->next) BT_OBJECT_SET_NEXT(context->next, obj);
 	context->next = obj;
 	
@@ -77,7 +245,7 @@ static void free_subobjects(bt_Context* context, bt_Object* obj)
 				bt_buffer_destroy(context, &type->as.userdata.fields);
 				break;
 			}
-			bt_gc_free(context, type->name, 0); // Length is not tracked
+			bt_gc_free(context, type->name, strlen(type->name) + 1);
 		}
 	} break;
 	case BT_OBJECT_TYPE_MODULE: {
@@ -95,7 +263,7 @@ static void free_subobjects(bt_Context* context, bt_Object* obj)
 
 			bt_buffer_destroy(context, &mod->debug_tokens);
 			bt_gc_free(context, mod->debug_locs, sizeof(bt_DebugLocBuffer));
-			context->free(mod->debug_source); // FIXME: Size of this is not tracked
+			bt_gc_free(context, mod->debug_source, strlen(mod->debug_source) + 1);
 		}
 	} break;
 	case BT_OBJECT_TYPE_FN: {
@@ -110,17 +278,18 @@ static void free_subobjects(bt_Context* context, bt_Object* obj)
 	case BT_OBJECT_TYPE_TABLE: {
 		bt_Table* tbl = (bt_Table*)obj;
 		if (!tbl->is_inline && tbl->capacity > 0) {
-			bt_gc_free(context, tbl->outline, tbl->capacity * sizeof(bt_TablePair));
+			bt_gc_free(context, tbl->outline, BT_TABLE_OUTLINE_SIZE(tbl->capacity));
 		}
 	} break;
 	case BT_OBJECT_TYPE_STRING: {
 		bt_String* str = (bt_String*)obj;
-		if (str->len <= BT_STRINGTABLE_MAX_LEN) {
-			bt_remove_interned(context, str);
+		if (str->is_slice && ((bt_StringSlice*)str)->parent == NULL) {
+			bt_gc_free(context, ((bt_StringSlice*)str)->data, str->len + 1);
 		}
 	} break;
 	case BT_OBJECT_TYPE_ARRAY: {
 		bt_Array* arr = (bt_Array*)obj;
+		if (arr->is_view && ((bt_ArrayView*)arr)->parent) break;
 		bt_gc_free(context, arr->items, arr->capacity * sizeof(bt_Value));
 	} break;
 	case BT_OBJECT_TYPE_USERDATA: {
@@ -138,14 +307,14 @@ static size_t get_object_size(bt_Object* obj)
 	switch (BT_OBJECT_GET_TYPE(obj)) {
 	case BT_OBJECT_TYPE_NONE: return sizeof(bt_Object);
 	case BT_OBJECT_TYPE_TYPE: return sizeof(bt_Type);
-	case BT_OBJECT_TYPE_STRING: return sizeof(bt_String) + ((bt_String*)obj)->len;
+	case BT_OBJECT_TYPE_STRING: return ((bt_String*)obj)->is_slice ? sizeof(bt_StringSlice) : sizeof(bt_String) + ((bt_String*)obj)->len + 1;
 	case BT_OBJECT_TYPE_MODULE: return sizeof(bt_Module);
 	case BT_OBJECT_TYPE_IMPORT: return sizeof(bt_ModuleImport);
 	case BT_OBJECT_TYPE_FN: return sizeof(bt_Fn);
 	case BT_OBJECT_TYPE_NATIVE_FN: return sizeof(bt_NativeFn);
 	case BT_OBJECT_TYPE_CLOSURE: return sizeof(bt_Closure) + ((bt_Closure*)obj)->num_upv * sizeof(bt_Value);
-	case BT_OBJECT_TYPE_ARRAY: return sizeof(bt_Array);
-	case BT_OBJECT_TYPE_TABLE: return sizeof(bt_Table) + sizeof(bt_TablePair) * ((bt_Table*)obj)->inline_capacity - sizeof(bt_Value);
+	case BT_OBJECT_TYPE_ARRAY: return ((bt_Array*)obj)->is_view ? sizeof(bt_ArrayView) : sizeof(bt_Array);
+	case BT_OBJECT_TYPE_TABLE: return sizeof(bt_Table) + BT_TABLE_INLINE_STORAGE(((bt_Table*)obj)->inline_capacity);
 	case BT_OBJECT_TYPE_USERDATA: return sizeof(bt_Userdata) + ((bt_Userdata*)obj)->size;
 	case BT_OBJECT_TYPE_ANNOTATION: return sizeof(bt_Annotation);
 	default:
@@ -157,6 +326,39 @@ static size_t get_object_size(bt_Object* obj)
 
 }
 
+size_t bt_gc_get_object_footprint(bt_Object* obj)
+{
+	size_t size = get_object_size(obj);
+
+	switch (BT_OBJECT_GET_TYPE(obj)) {
+	case BT_OBJECT_TYPE_MODULE: {
+		bt_Module* mod = (bt_Module*)obj;
+		size += mod->constants.capacity * sizeof(bt_Value);
+		size += mod->instructions.capacity * sizeof(bt_Op);
+		size += mod->imports.capacity * sizeof(bt_ModuleImport*);
+	} break;
+	case BT_OBJECT_TYPE_FN: {
+		bt_Fn* fn = (bt_Fn*)obj;
+		size += fn->constants.capacity * sizeof(bt_Value);
+		size += fn->instructions.capacity * sizeof(bt_Op);
+	} break;
+	case BT_OBJECT_TYPE_ARRAY: {
+		bt_Array* arr = (bt_Array*)obj;
+		size += arr->capacity * sizeof(bt_Value);
+	} break;
+	case BT_OBJECT_TYPE_TABLE: {
+		bt_Table* tbl = (bt_Table*)obj;
+		if (!tbl->is_inline) size += BT_TABLE_OUTLINE_SIZE(tbl->capacity);
+	} break;
+	case BT_OBJECT_TYPE_STRING: {
+		bt_String* str = (bt_String*)obj;
+		if (str->is_slice && ((bt_StringSlice*)str)->parent == NULL) size += str->len + 1;
+	} break;
+	}
+
+	return size;
+}
+
 void bt_free(bt_Context* context, bt_Object* obj)
 {
 	free_subobjects(context, obj);
@@ -179,6 +381,14 @@ void bt_make_gc(bt_Context* ctx)
 void bt_destroy_gc(bt_Context* ctx, bt_GC* gc)
 {
 	bt_gc_free(ctx, gc->greys, gc->grey_cap * sizeof(bt_Object*));
+
+	bt_ArenaChunk* chunk = gc->arena_chunks;
+	while (chunk) {
+		bt_ArenaChunk* next = chunk->next;
+		ctx->allocator.free(ctx->allocator.userdata, chunk, sizeof(bt_ArenaChunk) + chunk->size);
+		chunk = next;
+	}
+	gc->arena_chunks = gc->arena_current = NULL;
 }
 
 size_t bt_gc_get_next_cycle(bt_Context* ctx)
@@ -245,145 +455,298 @@ static void grey(bt_GC* gc, bt_Object* obj) {
 	gc->greys[gc->grey_count++] = obj;
 }
 
+uint32_t bt_gc_get_sweep_step(bt_Context* ctx)
+{
+	return ctx->gc.sweep_step;
+}
+
+void bt_gc_set_sweep_step(bt_Context* ctx, uint32_t sweep_step)
+{
+	ctx->gc.sweep_step = sweep_step;
+}
+
+size_t bt_gc_get_memory_limit(bt_Context* ctx)
+{
+	return ctx->gc.memory_limit;
+}
+
+void bt_gc_set_memory_limit(bt_Context* ctx, size_t limit)
+{
+	ctx->gc.memory_limit = limit;
+}
+
+bt_bool bt_gc_get_defer_finalizers(bt_Context* ctx)
+{
+	return ctx->gc.defer_finalizers;
+}
+
+void bt_gc_set_defer_finalizers(bt_Context* ctx, bt_bool defer)
+{
+	ctx->gc.defer_finalizers = defer;
+}
+
 void bt_grey_obj(bt_Context* ctx, bt_Object* obj)
 {
 	grey(&ctx->gc, obj);
 }
 
-static void blacken(bt_GC* gc, bt_Object* obj)
+#define VISIT(__obj) do { bt_Object* __ref = (bt_Object*)(__obj); if (__ref) visit(__ref, visit_userdata); } while (0)
+#define VISIT_VALUE(__val) do { bt_Value __v = (__val); if (BT_IS_OBJECT(__v)) VISIT(BT_AS_OBJECT(__v)); } while (0)
+
+/** Shared traversal for marking and heap inspection, forced inline so the mark phase pays nothing for the indirection */
+static BT_FORCE_INLINE void traverse_object(bt_Object* obj, bt_ReferenceVisitor visit, void* visit_userdata)
 {
 	switch (BT_OBJECT_GET_TYPE(obj)) {
 	case BT_OBJECT_TYPE_NONE: break; // Reserved for root object
 	case BT_OBJECT_TYPE_TYPE: {
 		bt_Type* as_type = (bt_Type*)obj;
 
-		grey(gc, (bt_Object*)as_type->prototype);
-		grey(gc, (bt_Object*)as_type->prototype_types);
-		grey(gc, (bt_Object*)as_type->prototype_values);
-		grey(gc, (bt_Object*)as_type->annotations);
+		VISIT(as_type->prototype);
+		VISIT(as_type->prototype_types);
+		VISIT(as_type->prototype_values);
+		VISIT(as_type->annotations);
 
 		switch (as_type->category) {
 		case BT_TYPE_CATEGORY_ARRAY:
-			grey(gc, (bt_Object*)as_type->as.array.inner);
+			VISIT(as_type->as.array.inner);
 			break;
 		case BT_TYPE_CATEGORY_NATIVE_FN:
 		case BT_TYPE_CATEGORY_SIGNATURE: {
-				grey(gc, (bt_Object*)as_type->as.fn.return_type);
-				grey(gc, (bt_Object*)as_type->as.fn.varargs_type);
+				VISIT(as_type->as.fn.return_type);
+				VISIT(as_type->as.fn.varargs_type);
 				for (uint32_t i = 0; i < as_type->as.fn.args.length; ++i) {
 					bt_Type* arg = as_type->as.fn.args.elements[i];
-					grey(gc, (bt_Object*)arg);
+					VISIT(arg);
 				}
 		} break;
 		case BT_TYPE_CATEGORY_TABLESHAPE: {
-				grey(gc, (bt_Object*)as_type->as.table_shape.tmpl);
-				grey(gc, (bt_Object*)as_type->as.table_shape.layout);
-				grey(gc, (bt_Object*)as_type->as.table_shape.key_layout);
-				grey(gc, (bt_Object*)as_type->as.table_shape.parent);
-				grey(gc, (bt_Object*)as_type->as.table_shape.key_type);
-				grey(gc, (bt_Object*)as_type->as.table_shape.value_type);
+				VISIT(as_type->as.table_shape.tmpl);
+				VISIT(as_type->as.table_shape.layout);
+				VISIT(as_type->as.table_shape.key_layout);
+				VISIT(as_type->as.table_shape.parent);
+				VISIT(as_type->as.table_shape.key_type);
+				VISIT(as_type->as.table_shape.value_type);
+				VISIT(as_type->as.table_shape.field_annotations);
 		} break;
 		case BT_TYPE_CATEGORY_TYPE: {
-				grey(gc, (bt_Object*)as_type->as.type.boxed);
+				VISIT(as_type->as.type.boxed);
 		} break;
 		case BT_TYPE_CATEGORY_USERDATA: {
 				bt_FieldBuffer* fields = &as_type->as.userdata.fields;
 				for (uint32_t i = 0; i < fields->length; i++) {
 					bt_UserdataField* field = fields->elements + i;
-					grey(gc, (bt_Object*)field->bolt_type);
-					grey(gc, (bt_Object*)field->name);
+					VISIT(field->bolt_type);
+					VISIT(field->name);
 				}
 		} break;
 		case BT_TYPE_CATEGORY_UNION: {
 				bt_TypeBuffer* entries = &as_type->as.selector.types;
 				for (uint32_t i = 0; i < entries->length; ++i) {
 					bt_Type* type = entries->elements[i];
-					grey(gc, (bt_Object*)type);
+					VISIT(type);
 				}
 		} break;
 		case BT_TYPE_CATEGORY_ENUM: {
-				grey(gc, (bt_Object*)as_type->as.enum_.name);
-				grey(gc, (bt_Object*)as_type->as.enum_.options);
+				VISIT(as_type->as.enum_.name);
+				VISIT(as_type->as.enum_.options);
 		} break;
 		}	
 	} break;
 	case BT_OBJECT_TYPE_MODULE: {
 		bt_Module* mod = (bt_Module*)obj;
-		grey(gc, (bt_Object*)mod->type);
-		grey(gc, (bt_Object*)mod->exports);
-		grey(gc, (bt_Object*)mod->name);
-		grey(gc, (bt_Object*)mod->path);
-		grey(gc, (bt_Object*)mod->storage);
+		VISIT(mod->type);
+		VISIT(mod->exports);
+		VISIT(mod->name);
+		VISIT(mod->path);
+		VISIT(mod->storage);
 
 		for (uint32_t i = 0; i < mod->imports.length; ++i) {
 			bt_Object* import = (bt_Object*)mod->imports.elements[i];
-			grey(gc, import);
+			VISIT(import);
 		}
 
 		for (uint32_t i = 0; i < mod->constants.length; ++i) {
 			bt_Value constant = mod->constants.elements[i];
-			if (BT_IS_OBJECT(constant)) {
-				grey(gc, BT_AS_OBJECT(constant));
-			}
+			VISIT_VALUE(constant);
 		}
 	} break;
 	case BT_OBJECT_TYPE_IMPORT: {
 		bt_ModuleImport* import = (bt_ModuleImport*)obj;
-		grey(gc, (bt_Object*)import->type);
-		grey(gc, (bt_Object*)import->name);
-		if(BT_IS_OBJECT(import->value)) grey(gc, BT_AS_OBJECT(import->value));
+		VISIT(import->type);
+		VISIT(import->name);
+		VISIT_VALUE(import->value);
 	} break;
 	case BT_OBJECT_TYPE_FN: {
 		bt_Fn* fn = (bt_Fn*)obj;
-		grey(gc, (bt_Object*)fn->module);
-		grey(gc, (bt_Object*)fn->signature);
+		VISIT(fn->module);
+		VISIT(fn->signature);
 		for (uint32_t i = 0; i < fn->constants.length; ++i) {
 			bt_Value constant = fn->constants.elements[i];
-			if (BT_IS_OBJECT(constant)) {
-				grey(gc, BT_AS_OBJECT(constant));
-			}
-		};
+			VISIT_VALUE(constant);
+		}
 	} break;
 	case BT_OBJECT_TYPE_CLOSURE: {
 		bt_Closure* cl = (bt_Closure*)obj;
-		grey(gc, (bt_Object*)cl->fn);
+		VISIT(cl->fn);
 		for (uint32_t i = 0; i < cl->num_upv; ++i) {
 			bt_Value upval = BT_CLOSURE_UPVALS(cl)[i];
-			if (BT_IS_OBJECT(upval)) grey(gc, BT_AS_OBJECT(upval));
-		};
+			VISIT_VALUE(upval);
+		}
 	} break;
 	case BT_OBJECT_TYPE_NATIVE_FN: {
 		bt_NativeFn* ntfn = (bt_NativeFn*)obj;
-		grey(gc, (bt_Object*)ntfn->type);
+		VISIT(ntfn->type);
+	} break;
+	case BT_OBJECT_TYPE_STRING: {
+		bt_String* str = (bt_String*)obj;
+		if (str->is_slice) VISIT(((bt_StringSlice*)str)->parent);
 	} break;
 	case BT_OBJECT_TYPE_TABLE: {
 		bt_Table* tbl = (bt_Table*)obj;
-		grey(gc, (bt_Object*)tbl->prototype);
+		VISIT(tbl->prototype);
 		for (uint32_t i = 0; i < tbl->length; i++) {
 			bt_TablePair* pair = BT_TABLE_PAIRS(tbl) + i;
-			if (BT_IS_OBJECT(pair->key))   grey(gc, BT_AS_OBJECT(pair->key));
-			if (BT_IS_OBJECT(pair->value)) grey(gc, BT_AS_OBJECT(pair->value));
+			VISIT_VALUE(pair->key);
+			VISIT_VALUE(pair->value);
 		}
 	} break;
 	case BT_OBJECT_TYPE_USERDATA: {
 		bt_Userdata* userdata = (bt_Userdata*)obj;
-		grey(gc, (bt_Object*)userdata->type);
+		VISIT(userdata->type);
 	} break;
 	case BT_OBJECT_TYPE_ARRAY: {
 		bt_Array* arr = (bt_Array*)obj;
+		if (arr->is_view && ((bt_ArrayView*)arr)->parent) {
+			VISIT(((bt_ArrayView*)arr)->parent);
+			break;
+		}
+
 		for (uint32_t i = 0; i < arr->length; i++) {
-			if (BT_IS_OBJECT(arr->items[i])) grey(gc, BT_AS_OBJECT(arr->items[i]));
+			VISIT_VALUE(arr->items[i]);
 		}
 	} break;
 	case BT_OBJECT_TYPE_ANNOTATION: {
 		bt_Annotation* anno = (bt_Annotation*)obj;
-		grey(gc, (bt_Object*)anno->name);
-		grey(gc, (bt_Object*)anno->args);
-		grey(gc, (bt_Object*)anno->next);
+		VISIT(anno->name);
+		VISIT(anno->args);
+		VISIT(anno->next);
 	} break;
 	}
 }
 
+void bt_gc_visit_references(bt_Object* obj, bt_ReferenceVisitor visitor, void* userdata)
+{
+	traverse_object(obj, visitor, userdata);
+}
+
+static void grey_reference(bt_Object* obj, void* gc)
+{
+	grey((bt_GC*)gc, obj);
+}
+
+static void blacken(bt_GC* gc, bt_Object* obj)
+{
+	traverse_object(obj, grey_reference, gc);
+}
+
+#define VISIT_ROOT(__obj, __name) do { bt_Object* __ref = (bt_Object*)(__obj); if (__ref) visit(__ref, __name, userdata); } while (0)
+
+static BT_FORCE_INLINE void traverse_thread(bt_Thread* thr, bt_RootVisitor visit, void* userdata)
+{
+	if (thr->depth == 0) return;
+
+	uint32_t user_bottom = thr->top + BT_STACKFRAME_GET_SIZE(thr->callstack[thr->depth - 1]);
+	uint32_t user_top = user_bottom + BT_STACKFRAME_GET_USER_TOP(thr->callstack[thr->depth - 1]);
+
+	bt_Callable* current = BT_STACKFRAME_GET_CALLABLE(thr->callstack[thr->depth - 1]);
+	uint32_t top = thr->top + bt_get_top_at(current, thr->ip);
+
+	// Natives have no frame of their own, their arguments sit right at the top and may be the only reference to a temporary
+	bt_Object* current_fn = BT_OBJECT_GET_TYPE(current) == BT_OBJECT_TYPE_CLOSURE ? (bt_Object*)((bt_Closure*)current)->fn : (bt_Object*)current;
+	if (BT_OBJECT_GET_TYPE(current_fn) == BT_OBJECT_TYPE_NATIVE_FN && thr->native_depth) {
+		top += thr->native_stack[thr->native_depth - 1].argc;
+	}
+	
+	for (uint32_t i = 0; i < thr->depth; ++i) {
+		bt_StackFrame stck = thr->callstack[i];
+		VISIT_ROOT(BT_STACKFRAME_GET_CALLABLE(stck), "callstack");
+	}
+
+	for (uint32_t i = 0; i < top; ++i) {
+		bt_Value val = thr->stack[i];
+		if (BT_IS_OBJECT(val)) VISIT_ROOT(BT_AS_OBJECT(val), "stack");
+	}
+
+	// bt_push() moves the user top before writing, so pushed values sit one slot above `user_bottom`
+	for (uint32_t i = user_bottom + 1; i <= user_top; ++i) {
+		bt_Value val = thr->stack[i];
+		if (BT_IS_OBJECT(val)) VISIT_ROOT(BT_AS_OBJECT(val), "stack");
+	}
+
+	VISIT_ROOT(thr->last_error, "last_error");
+}
+
+/** Visits everything the gc treats as a root, with a short description of where it's held from */
+static BT_FORCE_INLINE void traverse_roots(bt_Context* ctx, bt_RootVisitor visit, void* userdata)
+{
+	VISIT_ROOT(ctx->types.any, "types.any");
+	VISIT_ROOT(ctx->types.null, "types.null");
+	VISIT_ROOT(ctx->types.number, "types.number");
+	VISIT_ROOT(ctx->types.boolean, "types.boolean");
+	VISIT_ROOT(ctx->types.string, "types.string");
+	VISIT_ROOT(ctx->types.array, "types.array");
+	VISIT_ROOT(ctx->types.table, "types.table");
+	VISIT_ROOT(ctx->types.type, "types.type");
+	VISIT_ROOT(ctx->types.module, "types.module");
+	
+	VISIT_ROOT(ctx->meta_names.add, "meta_names");
+	VISIT_ROOT(ctx->meta_names.sub, "meta_names");
+	VISIT_ROOT(ctx->meta_names.mul, "meta_names");
+	VISIT_ROOT(ctx->meta_names.div, "meta_names");
+	VISIT_ROOT(ctx->meta_names.lt, "meta_names");
+	VISIT_ROOT(ctx->meta_names.lte, "meta_names");
+	VISIT_ROOT(ctx->meta_names.eq, "meta_names");
+	VISIT_ROOT(ctx->meta_names.neq, "meta_names");
+	VISIT_ROOT(ctx->meta_names.format, "meta_names");
+	
+	VISIT_ROOT(ctx->root, "root");
+	VISIT_ROOT(ctx->type_registry, "type_registry");
+	VISIT_ROOT(ctx->prelude, "prelude");
+	VISIT_ROOT(ctx->loaded_modules, "loaded_modules");
+	VISIT_ROOT(ctx->native_references, "native_references");
+
+	for (uint32_t i = 0; i < 256; ++i) {
+		VISIT_ROOT(ctx->byte_strings[i], "byte_strings");
+	}
+	VISIT_ROOT(ctx->empty_string, "empty_string");
+
+	for (uint32_t i = 0; i < BT_SMALL_INT_STRINGS; ++i) {
+		VISIT_ROOT(ctx->small_int_strings[i], "small_int_strings");
+	}
+	VISIT_ROOT(ctx->true_string, "true_string");
+	VISIT_ROOT(ctx->false_string, "false_string");
+	VISIT_ROOT(ctx->null_string, "null_string");
+
+	for (uint32_t i = 0; i < ctx->troot_top; ++i) {
+		VISIT_ROOT(ctx->troots[i], "troots");
+	}
+	
+	// Threads started from within a native call (such as `core.protect`) keep their callers suspended, so those are roots too
+	for (bt_Thread* thr = ctx->current_thread; thr; thr = thr->parent) {
+		traverse_thread(thr, visit, userdata);
+	}
+}
+
+void bt_gc_visit_roots(bt_Context* ctx, bt_RootVisitor visitor, void* userdata)
+{
+	traverse_roots(ctx, visitor, userdata);
+}
+
+static void grey_root(bt_Object* obj, const char* name, void* gc)
+{
+	grey((bt_GC*)gc, obj);
+}
+
 static void calc_next_cycle(bt_GC* gc, size_t growth_factor)
 {
 	gc->next_cycle = (gc->bytes_allocated * growth_factor) / 100;
@@ -399,82 +762,97 @@ uint32_t bt_collect(bt_GC* gc, uint32_t max_collect)
 	
 	bt_Context* ctx = gc->ctx;
 
-	grey(gc, (bt_Object*)ctx->types.any);
-	grey(gc, (bt_Object*)ctx->types.null);
-	grey(gc, (bt_Object*)ctx->types.number);
-	grey(gc, (bt_Object*)ctx->types.boolean);
-	grey(gc, (bt_Object*)ctx->types.string);
-	grey(gc, (bt_Object*)ctx->types.array);
-	grey(gc, (bt_Object*)ctx->types.table);
-	grey(gc, (bt_Object*)ctx->types.type);
-	grey(gc, (bt_Object*)ctx->types.module);
-	
-	grey(gc, (bt_Object*)ctx->meta_names.add);
-	grey(gc, (bt_Object*)ctx->meta_names.sub);
-	grey(gc, (bt_Object*)ctx->meta_names.mul);
-	grey(gc, (bt_Object*)ctx->meta_names.div);
-	grey(gc, (bt_Object*)ctx->meta_names.lt);
-	grey(gc, (bt_Object*)ctx->meta_names.lte);
-	grey(gc, (bt_Object*)ctx->meta_names.eq);
-	grey(gc, (bt_Object*)ctx->meta_names.neq);
-	grey(gc, (bt_Object*)ctx->meta_names.format);
-	
-	grey(gc, (bt_Object*)ctx->root);
-	grey(gc, (bt_Object*)ctx->type_registry);
-	grey(gc, (bt_Object*)ctx->prelude);
-	grey(gc, (bt_Object*)ctx->loaded_modules);
-	grey(gc, (bt_Object*)ctx->native_references);
-
-	for (uint32_t i = 0; i < gc->ctx->troot_top; ++i) {
-		grey(gc, (bt_Object*)gc->ctx->troots[i]);
+	// Marking relies on every live object starting out clear, so the previous sweep has to be completed first
+	uint32_t n_collected = 0;
+	if (gc->sweep_cursor) {
+		n_collected = sweep(gc, 0);
 	}
-	
-	if (gc->ctx->current_thread) {
-		bt_Thread* thr = gc->ctx->current_thread;
-		
-		uint32_t user_bottom = thr->top + BT_STACKFRAME_GET_SIZE(thr->callstack[thr->depth - 1]);
-		uint32_t user_top = user_bottom + BT_STACKFRAME_GET_USER_TOP(thr->callstack[thr->depth - 1]);
-
-		bt_Callable* current = BT_STACKFRAME_GET_CALLABLE(thr->callstack[thr->depth - 1]);
-		uint32_t top = thr->top + bt_get_top_at(current, thr->ip);
-		
-		for (uint32_t i = 0; i < thr->depth; ++i) {
-			bt_StackFrame stck = thr->callstack[i];
-			grey(gc, (bt_Object*)BT_STACKFRAME_GET_CALLABLE(stck));
-		}
 
-		for (uint32_t i = 0; i < top; ++i) {
-			bt_Value val = thr->stack[i];
-			if (BT_IS_OBJECT(val)) grey(gc, BT_AS_OBJECT(val));
-		}
+	gc->collect_start = get_timestamp();
+	gc->in_collect = BT_TRUE;
 
-		for (uint32_t i = user_bottom; i < user_top; ++i) {
-			bt_Value val = thr->stack[i];
-			if (BT_IS_OBJECT(val)) grey(gc, BT_AS_OBJECT(val));
-		}
+	// Anything left unmarked may be freed from here on, so cached prototype lookups can't be trusted to point at live tables
+	ctx->proto_cache_epoch++;
+	if (gc->callback) gc->callback(ctx, BT_GC_EVENT_CYCLE_START, &gc->stats, gc->callback_userdata);
 
-		grey(gc, (bt_Object*)gc->ctx->current_thread->last_error);
-	}
+	traverse_roots(ctx, grey_root, gc);
 
 	while (gc->grey_count) {
 		bt_Object* obj = gc->greys[--gc->grey_count];
 		blacken(gc, obj);
 	}
 
-	// Clear interned strings that are no longer referenced from the string table
-	for (uint32_t i = 0; i < BT_STRINGTABLE_SIZE; i++) {
-		bt_StringTableBucket* bucket = &ctx->string_table[i];
-		for (uint32_t idx = 0; idx < bucket->length; ++idx) {
-			if (!BT_OBJECT_GET_MARK((bt_Object*)bucket->elements[idx].string)) {
-				bucket->elements[idx] = bucket->elements[--bucket->length];
-				idx--;				
-			}
-		}
+	// Clear interned strings that are no longer referenced from the string table. This has to happen before the sweep is
+	// armed, so a string waiting on a lazy sweep can never be handed back, and the sweep can then free them without touching it
+	bt_purge_interned(ctx);
+
+	memset(gc->sweep_live_objects, 0, sizeof(gc->sweep_live_objects));
+	memset(gc->sweep_live_bytes, 0, sizeof(gc->sweep_live_bytes));
+	gc->sweep_bytes_freed = 0;
+	gc->sweep_objects_freed = 0;
+
+	gc->sweep_cursor = ctx->root;
+	n_collected += sweep(gc, max_collect ? max_collect : gc->sweep_step);
+
+	// The sweep is left pending, so the pause ends here rather than at the end of the cycle
+	if (gc->in_collect) record_pause(gc);
+
+	return n_collected;
+}
+
+static void record_pause(bt_GC* gc)
+{
+	bt_GCStats* stats = &gc->stats;
+	uint64_t pause = get_timestamp() - gc->collect_start;
+	gc->in_collect = BT_FALSE;
+
+	stats->pause_history[stats->cycles % BT_GC_PAUSE_HISTORY_SIZE] = pause;
+	stats->cycles++;
+
+	stats->last_pause = pause;
+	stats->total_pause += pause;
+	if (pause > stats->max_pause) stats->max_pause = pause;
+
+	uint32_t bucket = 0;
+	uint64_t micros = pause / 1000;
+	while (micros && bucket < BT_GC_PAUSE_BUCKETS - 1) {
+		micros >>= 1;
+		bucket++;
 	}
-	
+	stats->pause_histogram[bucket]++;
+}
+
+/** Called once the sweep reaches the end of the heap, publishing the cycle's statistics */
+static void end_cycle(bt_GC* gc)
+{
+	bt_Context* ctx = gc->ctx;
+	bt_GCStats* stats = &gc->stats;
+
+	gc->sweep_cursor = NULL;
+	calc_next_cycle(gc, gc->cycle_growth_pct);
+
+	if (!gc->defer_finalizers) {
+		bt_run_finalizers(ctx);
+	}
+
+	if (gc->in_collect) record_pause(gc);
+
+	memcpy(stats->live_objects, gc->sweep_live_objects, sizeof(stats->live_objects));
+	memcpy(stats->live_bytes, gc->sweep_live_bytes, sizeof(stats->live_bytes));
+	stats->last_bytes_freed = gc->sweep_bytes_freed;
+	stats->last_objects_freed = gc->sweep_objects_freed;
+
+	if (gc->callback) gc->callback(ctx, BT_GC_EVENT_CYCLE_END, stats, gc->callback_userdata);
+}
+
+/** Walk up to `max_visit` objects from the sweep cursor (0 meaning the rest of the heap), freeing everything left unmarked */
+static uint32_t sweep(bt_GC* gc, uint32_t max_visit)
+{
+	bt_Context* ctx = gc->ctx;
 	uint32_t n_collected = 0;
+	uint32_t n_visited = 0;
 
-	bt_Object* prev = ctx->root;
+	bt_Object* prev = gc->sweep_cursor;
 	bt_Object* current = (bt_Object*)BT_OBJECT_NEXT(prev);
 
 	bt_Thread gc_thread = { 0 };
@@ -484,10 +862,16 @@ uint32_t bt_collect(bt_GC* gc, uint32_t max_collect)
 	bt_Thread* old_thr = ctx->current_thread;
 	ctx->current_thread = &gc_thread;
 
-	while (current) {
+	while (current && (max_visit == 0 || n_visited < max_visit)) {
+		n_visited++;
+
 		if (BT_OBJECT_GET_MARK(current)) {
 			BT_OBJECT_CLEAR(current);
 
+			bt_ObjectType type = BT_OBJECT_GET_TYPE(current);
+			gc->sweep_live_objects[type]++;
+			gc->sweep_live_bytes[type] += get_object_size(current);
+
 			prev = current;
 			current = (bt_Object*)BT_OBJECT_NEXT(current);
 		}
@@ -500,20 +884,245 @@ uint32_t bt_collect(bt_GC* gc, uint32_t max_collect)
 			if (ctx->next == to_free) {
 				ctx->next = prev;
 			}
-			
-			bt_free(ctx, to_free);
 
 			n_collected++;
-			if (max_collect != 0 && n_collected >= max_collect) return n_collected;
+
+			// Userdata finalizers run outside of the sweep, so they're unlinked and queued up instead
+			if (BT_OBJECT_GET_TYPE(to_free) == BT_OBJECT_TYPE_USERDATA && ((bt_Userdata*)to_free)->finalizer) {
+				BT_OBJECT_SET_NEXT(to_free, NULL);
+				if (gc->finalize_tail) BT_OBJECT_SET_NEXT(gc->finalize_tail, to_free);
+				else gc->finalize_head = to_free;
+				gc->finalize_tail = to_free;
+				continue;
+			}
+
+			size_t before = gc->bytes_allocated;
+			bt_free(ctx, to_free);
+			gc->sweep_bytes_freed += before - gc->bytes_allocated;
+			gc->stats.total_bytes_freed += before - gc->bytes_allocated;
 		}
 	}
 
-	calc_next_cycle(gc, gc->cycle_growth_pct);
 	ctx->current_thread = old_thr;
+	gc->sweep_objects_freed += n_collected;
+	gc->stats.total_objects_freed += n_collected;
+
+	if (current) {
+		gc->sweep_cursor = prev;
+	}
+	else {
+		end_cycle(gc);
+	}
 
 	return n_collected;
 }
 
+bt_bool bt_gc_is_sweeping(bt_Context* ctx)
+{
+	return ctx->gc.sweep_cursor != NULL;
+}
+
+uint32_t bt_gc_finish_sweep(bt_Context* ctx)
+{
+	if (!ctx->gc.sweep_cursor) return 0;
+	return sweep(&ctx->gc, 0);
+}
+
+uint32_t bt_run_finalizers(bt_Context* ctx)
+{
+	bt_GC* gc = &ctx->gc;
+	uint32_t n_finalized = 0;
+
+	// Finalizers are free to allocate, make sure that doesn't kick off a cycle while the queue is being drained
+	bt_gc_pause(ctx);
+
+	while (gc->finalize_head) {
+		bt_Object* obj = gc->finalize_head;
+		gc->finalize_head = (bt_Object*)BT_OBJECT_NEXT(obj);
+		if (!gc->finalize_head) gc->finalize_tail = NULL;
+
+		size_t before = gc->bytes_allocated;
+		bt_free(ctx, obj);
+		if (gc->bytes_allocated < before) {
+			gc->sweep_bytes_freed += before - gc->bytes_allocated;
+			gc->stats.total_bytes_freed += before - gc->bytes_allocated;
+		}
+		n_finalized++;
+	}
+
+	bt_gc_unpause(ctx);
+
+	return n_finalized;
+}
+
+const bt_GCStats* bt_gc_get_stats(bt_Context* ctx)
+{
+	return &ctx->gc.stats;
+}
+
+uint64_t bt_gc_get_pause_percentile(bt_Context* ctx, uint32_t percentile)
+{
+	bt_GCStats* stats = &ctx->gc.stats;
+	uint32_t count = stats->cycles < BT_GC_PAUSE_HISTORY_SIZE ? (uint32_t)stats->cycles : BT_GC_PAUSE_HISTORY_SIZE;
+	if (count == 0) return 0;
+	if (percentile > 100) percentile = 100;
+
+	uint64_t sorted[BT_GC_PAUSE_HISTORY_SIZE];
+	for (uint32_t i = 0; i < count; ++i) {
+		uint64_t pause = stats->pause_history[i];
+		uint32_t j = i;
+		while (j > 0 && sorted[j - 1] > pause) {
+			sorted[j] = sorted[j - 1];
+			j--;
+		}
+		sorted[j] = pause;
+	}
+
+	uint32_t rank = (percentile * count + 99) / 100;
+	return sorted[rank ? rank - 1 : 0];
+}
+
+const char* bt_gc_object_type_name(bt_ObjectType type)
+{
+	switch (type) {
+	case BT_OBJECT_TYPE_NONE: return "none";
+	case BT_OBJECT_TYPE_TYPE: return "type";
+	case BT_OBJECT_TYPE_STRING: return "string";
+	case BT_OBJECT_TYPE_MODULE: return "module";
+	case BT_OBJECT_TYPE_IMPORT: return "import";
+	case BT_OBJECT_TYPE_FN: return "fn";
+	case BT_OBJECT_TYPE_NATIVE_FN: return "native_fn";
+	case BT_OBJECT_TYPE_CLOSURE: return "closure";
+	case BT_OBJECT_TYPE_ARRAY: return "array";
+	case BT_OBJECT_TYPE_TABLE: return "table";
+	case BT_OBJECT_TYPE_USERDATA: return "userdata";
+	case BT_OBJECT_TYPE_ANNOTATION: return "annotation";
+	default: return "unknown";
+	}
+}
+
+void bt_gc_set_callback(bt_Context* ctx, bt_GCCallback callback, void* userdata)
+{
+	ctx->gc.callback = callback;
+	ctx->gc.callback_userdata = userdata;
+}
+
+bt_ArenaMark bt_arena_mark(bt_Context* ctx)
+{
+	bt_GC* gc = &ctx->gc;
+
+	bt_ArenaMark mark;
+	mark.tail = ctx->next;
+	mark.chunk = gc->arena_current;
+	mark.used = gc->arena_current ? gc->arena_current->used : 0;
+	mark.finalizers = gc->arena_finalizers;
+	mark.depth = gc->arena_depth;
+
+	if (gc->arena_depth == 0) {
+		// A pending sweep would otherwise walk straight into the arena objects appended behind it
+		bt_gc_finish_sweep(ctx);
+		bt_gc_pause(ctx);
+		gc->arena_base = mark;
+	}
+
+	gc->arena_depth++;
+	return mark;
+}
+
+void bt_arena_reset(bt_Context* ctx, bt_ArenaMark mark)
+{
+	bt_GC* gc = &ctx->gc;
+	if (gc->arena_depth <= mark.depth) return;
+
+#ifdef BT_DEBUG
+	assert(bt_arena_check_escapes(ctx, mark) == 0 && "Objects allocated in the arena are still referenced from outside it!");
+#endif
+
+	for (bt_ArenaFinalizer* finalizer = gc->arena_finalizers; finalizer != mark.finalizers; finalizer = finalizer->next) {
+		bt_Userdata* userdata = (bt_Userdata*)finalizer->obj;
+		if (userdata->finalizer) userdata->finalizer(ctx, userdata);
+	}
+	gc->arena_finalizers = mark.finalizers;
+
+	// Every object allocated since the mark was appended after its tail, so cutting the list there drops them all
+	BT_OBJECT_SET_NEXT(mark.tail, NULL);
+	ctx->next = mark.tail;
+	ctx->proto_cache_epoch++;
+
+	gc->arena_current = mark.chunk;
+	if (mark.chunk) mark.chunk->used = mark.used;
+
+	gc->arena_depth = mark.depth;
+	if (gc->arena_depth == 0) bt_gc_unpause(ctx);
+}
+
+bt_bool bt_arena_is_active(bt_Context* ctx)
+{
+	return ctx->gc.arena_depth > 0;
+}
+
+typedef struct bt_EscapeCheck {
+	bt_GC* gc;
+	bt_ArenaMark* mark;
+	uint32_t escapes;
+} bt_EscapeCheck;
+
+static bt_bool allocated_since(bt_EscapeCheck* check, void* ptr)
+{
+	bt_GC* gc = check->gc;
+	if (!ptr || !gc->arena_current) return BT_FALSE;
+
+	bt_ArenaChunk* chunk = check->mark->chunk ? check->mark->chunk : gc->arena_chunks;
+	size_t from = check->mark->chunk ? check->mark->used : 0;
+
+	for (; chunk; chunk = chunk->next, from = 0) {
+		char* data = ARENA_CHUNK_DATA(chunk);
+		if ((char*)ptr >= data + from && (char*)ptr < data + chunk->used) return BT_TRUE;
+		if (chunk == gc->arena_current) break;
+	}
+
+	return BT_FALSE;
+}
+
+static void check_reference(bt_Object* obj, void* userdata)
+{
+	bt_EscapeCheck* check = (bt_EscapeCheck*)userdata;
+	if (allocated_since(check, obj)) check->escapes++;
+}
+
+static void check_root(bt_Object* obj, const char* name, void* userdata)
+{
+	check_reference(obj, userdata);
+}
+
+uint32_t bt_arena_check_escapes(bt_Context* ctx, bt_ArenaMark mark)
+{
+	bt_EscapeCheck check;
+	check.gc = &ctx->gc;
+	check.mark = &mark;
+	check.escapes = 0;
+
+	traverse_roots(ctx, check_root, &check);
+
+	for (bt_Object* obj = ctx->root; obj; obj = (bt_Object*)BT_OBJECT_NEXT(obj)) {
+		traverse_object(obj, check_reference, &check);
+
+		// Owned storage counts too, growing an older container could have moved it into the arena
+		if (BT_OBJECT_GET_TYPE(obj) == BT_OBJECT_TYPE_ARRAY) {
+			bt_Array* arr = (bt_Array*)obj;
+			bt_bool owns_items = !arr->is_view || ((bt_ArrayView*)arr)->parent == NULL;
+			if (owns_items && allocated_since(&check, arr->items)) check.escapes++;
+		}
+		else if (BT_OBJECT_GET_TYPE(obj) == BT_OBJECT_TYPE_TABLE && !((bt_Table*)obj)->is_inline) {
+			if (allocated_since(&check, ((bt_Table*)obj)->outline)) check.escapes++;
+		}
+
+		if (obj == mark.tail) break;
+	}
+
+	return check.escapes;
+}
+
 void bt_gc_pause(bt_Context* ctx)
 {
 	ctx->gc.pause_count += 1;
@@ -8,6 +8,57 @@ extern "C" {
 
 #include <stdint.h>
 
+/** The number of distinct object types tracked by the per-type gc statistics */
+#define BT_GC_OBJECT_TYPES (BT_OBJECT_TYPE_ANNOTATION + 1)
+
+/** The number of buckets in the pause histogram. Bucket `n` counts the pauses that lasted less than 2^n microseconds */
+#define BT_GC_PAUSE_BUCKETS 24
+
+/** Telemetry gathered by the garbage collector. Pause times are in nanoseconds, and are only measured when `BOLT_ALLOW_CLOCK` is defined */
+typedef struct bt_GCStats {
+	uint64_t cycles;
+	uint64_t last_pause, max_pause, total_pause;
+	uint64_t pause_history[BT_GC_PAUSE_HISTORY_SIZE];
+	uint32_t pause_histogram[BT_GC_PAUSE_BUCKETS];
+
+	size_t last_bytes_freed, last_objects_freed;
+	size_t total_bytes_freed, total_objects_freed;
+	size_t total_bytes_allocated, total_objects_allocated;
+
+	size_t live_objects[BT_GC_OBJECT_TYPES];
+	size_t live_bytes[BT_GC_OBJECT_TYPES];
+} bt_GCStats;
+
+/** Events reported to the gc callback */
+typedef enum {
+	BT_GC_EVENT_CYCLE_START,
+	BT_GC_EVENT_CYCLE_END,
+} bt_GCEvent;
+
+/** Invoked at the start of every gc cycle, and once again when it's fully swept */
+typedef void (*bt_GCCallback)(bt_Context* ctx, bt_GCEvent event, const bt_GCStats* stats, void* userdata);
+
+/** A block of bump-allocated memory backing the arena, with the data following the header */
+typedef struct bt_ArenaChunk {
+	struct bt_ArenaChunk* next;
+	size_t size, used;
+} bt_ArenaChunk;
+
+/** Userdata allocated inside the arena, kept around so their finalizers can run on reset */
+typedef struct bt_ArenaFinalizer {
+	bt_Object* obj;
+	struct bt_ArenaFinalizer* next;
+} bt_ArenaFinalizer;
+
+/** Position in the arena returned by `bt_arena_mark`, everything allocated after it is discarded by `bt_arena_reset` */
+typedef struct bt_ArenaMark {
+	bt_Object* tail;
+	bt_ArenaChunk* chunk;
+	size_t used;
+	bt_ArenaFinalizer* finalizers;
+	uint32_t depth;
+} bt_ArenaMark;
+
 /** Contains all internal state for the garbage collector, such as memory stats and pending greys */
 typedef struct bt_GC {
 	size_t next_cycle, bytes_allocated, min_size;
@@ -16,6 +67,32 @@ typedef struct bt_GC {
 	bt_Object** greys;
 	uint32_t pause_count;
 
+	size_t memory_limit;
+	bt_bool limit_exceeded;
+
+	bt_Object* sweep_cursor;
+	uint32_t sweep_step;
+
+	bt_Object* finalize_head;
+	bt_Object* finalize_tail;
+	bt_bool defer_finalizers;
+
+	bt_GCStats stats;
+	size_t sweep_live_objects[BT_GC_OBJECT_TYPES];
+	size_t sweep_live_bytes[BT_GC_OBJECT_TYPES];
+	size_t sweep_bytes_freed, sweep_objects_freed;
+	uint64_t collect_start;
+	bt_bool in_collect;
+
+	bt_GCCallback callback;
+	void* callback_userdata;
+
+	bt_ArenaChunk* arena_chunks;
+	bt_ArenaChunk* arena_current;
+	bt_ArenaFinalizer* arena_finalizers;
+	bt_ArenaMark arena_base;
+	uint32_t arena_depth;
+
 	bt_Context* ctx;
 } bt_GC;
 
@@ -77,10 +154,74 @@ BOLT_API size_t bt_gc_get_pause_growth_pct(bt_Context* ctx);
 /** Set the percentage of slack given if the gc hits the threshold during a pause, expressed as an integer */
 BOLT_API void bt_gc_set_pause_growth_pct(bt_Context* ctx, size_t growth_pct);
 
+/** Get the number of objects swept per allocation while a lazy sweep is pending. 0 means cycles sweep the entire heap immediately */
+BOLT_API uint32_t bt_gc_get_sweep_step(bt_Context* ctx);
+/** Set the number of objects swept per allocation after a cycle, spreading the sweep out over future allocations. 0 disables lazy sweeping */
+BOLT_API void bt_gc_set_sweep_step(bt_Context* ctx, uint32_t sweep_step);
+
+/** Get the maximum number of bytes the gc may track. 0 means unlimited */
+BOLT_API size_t bt_gc_get_memory_limit(bt_Context* ctx);
+/** Cap the number of bytes the gc may track, 0 meaning unlimited. Going over during execution runs a full cycle, and raises a catchable runtime error if that didn't free enough */
+BOLT_API void bt_gc_set_memory_limit(bt_Context* ctx, size_t limit);
+
+/** Returns whether userdata finalizers are queued until `bt_run_finalizers` is called, rather than ran at the end of each sweep */
+BOLT_API bt_bool bt_gc_get_defer_finalizers(bt_Context* ctx);
+/** Queue userdata finalizers until `bt_run_finalizers` is called, rather than running them at the end of each sweep */
+BOLT_API void bt_gc_set_defer_finalizers(bt_Context* ctx, bt_bool defer);
+
 /** Add an object to the grey set, meaning it'll be traversed during the next cycle */
 BOLT_API void bt_grey_obj(bt_Context* ctx, bt_Object* obj);
-/** Perform a gc cycle, stopping after `max_collect` objects. Returns the number of objects collected */
+/** Perform a gc cycle, sweeping at most `max_collect` objects immediately and leaving the rest to be swept lazily. 0 uses the configured sweep step. Returns the number of objects collected */
 BOLT_API uint32_t bt_collect(bt_GC* gc, uint32_t max_collect);
+/** Returns whether a lazy sweep is pending from the previous cycle */
+BOLT_API bt_bool bt_gc_is_sweeping(bt_Context* ctx);
+/** Finish any pending lazy sweep immediately. Returns the number of objects collected */
+BOLT_API uint32_t bt_gc_finish_sweep(bt_Context* ctx);
+/** Run and free all queued userdata finalizers. Returns the number of finalizers ran */
+BOLT_API uint32_t bt_run_finalizers(bt_Context* ctx);
+
+/** Get the telemetry gathered by the gc so far. Per-type live counts reflect the last fully swept cycle */
+BOLT_API const bt_GCStats* bt_gc_get_stats(bt_Context* ctx);
+/** Get the pause time in nanoseconds that `percentile` percent of recent cycles stayed under */
+BOLT_API uint64_t bt_gc_get_pause_percentile(bt_Context* ctx, uint32_t percentile);
+/** Returns a readable name for an object type, as used in gc statistics */
+BOLT_API const char* bt_gc_object_type_name(bt_ObjectType type);
+/** Set a callback to be invoked at the start and end of every gc cycle. Pass NULL to remove it */
+BOLT_API void bt_gc_set_callback(bt_Context* ctx, bt_GCCallback callback, void* userdata);
+
+/** Invoked for each object reached while traversing the heap */
+typedef void (*bt_ReferenceVisitor)(bt_Object* obj, void* userdata);
+/** Invoked for each gc root, `name` describes where the root is held from ("stack", "native_references", ...) */
+typedef void (*bt_RootVisitor)(bt_Object* obj, const char* name, void* userdata);
+
+/** Invoke `visitor` once for every object directly referenced by `obj`, following the same edges as the mark phase */
+BOLT_API void bt_gc_visit_references(bt_Object* obj, bt_ReferenceVisitor visitor, void* userdata);
+/** Invoke `visitor` once for every root the mark phase starts from. The same object may be visited more than once */
+BOLT_API void bt_gc_visit_roots(bt_Context* ctx, bt_RootVisitor visitor, void* userdata);
+/** Returns the number of bytes `obj` accounts for in the gc, including owned allocations such as array storage */
+BOLT_API size_t bt_gc_get_object_footprint(bt_Object* obj);
+
+/**
+ * Start allocating from the arena, returning a mark to later reset back to. Marks can be nested.
+ * While an arena is active the gc is paused, and every new object along with its owned storage is bump allocated.
+ * `bt_arena_reset` then discards all of it at once without tracing or sweeping.
+ * Objects created before the mark must not be left referencing anything created after it - under `BT_DEBUG`
+ * this is checked on reset. Growing older tables and arrays is safe, as their storage stays on the heap.
+ */
+BOLT_API bt_ArenaMark bt_arena_mark(bt_Context* ctx);
+/** Free everything allocated since `mark` in one go, running any userdata finalizers. Leaves arena mode once the outermost mark is reset */
+BOLT_API void bt_arena_reset(bt_Context* ctx, bt_ArenaMark mark);
+/** Returns whether any arena mark is currently active */
+BOLT_API bt_bool bt_arena_is_active(bt_Context* ctx);
+/** Returns whether `ptr` points into memory allocated from the active arena */
+BOLT_API bt_bool bt_arena_owns(bt_Context* ctx, void* ptr);
+/** Count the references into memory allocated since `mark` held by older objects or the gc roots. These would dangle after a reset */
+BOLT_API uint32_t bt_arena_check_escapes(bt_Context* ctx, bt_ArenaMark mark);
+
+/** Allocate storage owned by `owner`, which is only taken from the arena if `owner` was allocated from it too */
+BOLT_API void* bt_gc_alloc_owned(bt_Context* ctx, bt_Object* owner, size_t size);
+/** Realloc storage owned by `owner`, which is only taken from the arena if `owner` was allocated from it too */
+BOLT_API void* bt_gc_realloc_owned(bt_Context* ctx, bt_Object* owner, void* ptr, size_t old_size, size_t new_size);
 
 /** Pauses the gc, stopping it from cycling even if over budget. Uses a counter internally to allow safe nesting */
 BOLT_API void bt_gc_pause(bt_Context* ctx);
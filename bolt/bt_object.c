@@ -8,15 +8,95 @@
 #include <assert.h>
 #include <math.h>
 
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+// String hashing follows wyhash (final v4), consuming 8 bytes at a time and 48 per round for long strings
+#define BT_HASH_SECRET0 0x2d358dccaa6c78a5ull
+#define BT_HASH_SECRET1 0x8bb84b93962eacc9ull
+#define BT_HASH_SECRET2 0x4b33a62ed433d4a3ull
+#define BT_HASH_SECRET3 0x4d5a2da51de1aa47ull
+
+static BT_FORCE_INLINE uint64_t hash_read64(const uint8_t* p) { uint64_t v; memcpy(&v, p, sizeof(v)); return v; }
+static BT_FORCE_INLINE uint64_t hash_read32(const uint8_t* p) { uint32_t v; memcpy(&v, p, sizeof(v)); return v; }
+
+// Full 64x64 -> 128 bit multiply, leaving the low half in `a` and the high half in `b`
+static BT_FORCE_INLINE void hash_mum(uint64_t* a, uint64_t* b)
+{
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    *a = _umul128(*a, *b, b);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32), c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static BT_FORCE_INLINE uint64_t hash_mix(uint64_t a, uint64_t b)
+{
+    hash_mum(&a, &b);
+    return a ^ b;
+}
+
 uint64_t bt_hash_str(const char* key, uint32_t len)
 {
-    uint64_t h = 525201411107845655ull;
-    for (uint32_t i = 0; i < len; ++i, ++key) {
-        h ^= *key;
-        h *= 0x5bd1e9955bd1e995;
-        h ^= h >> 47;
+    const uint8_t* p = (const uint8_t*)key;
+    uint64_t seed = hash_mix(BT_HASH_SECRET0, BT_HASH_SECRET1);
+    uint64_t a, b;
+
+    if (len <= 16) {
+        if (len >= 4) {
+            uint32_t offset = (len >> 3) << 2;
+            a = (hash_read32(p) << 32) | hash_read32(p + offset);
+            b = (hash_read32(p + len - 4) << 32) | hash_read32(p + len - 4 - offset);
+        }
+        else if (len > 0) {
+            a = ((uint64_t)p[0] << 16) | ((uint64_t)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        }
+        else {
+            a = b = 0;
+        }
     }
-    return h;
+    else {
+        uint32_t remaining = len;
+        if (remaining > 48) {
+            // Three independent lanes keep the multipliers busy on long strings
+            uint64_t lane1 = seed, lane2 = seed;
+            do {
+                seed = hash_mix(hash_read64(p) ^ BT_HASH_SECRET1, hash_read64(p + 8) ^ seed);
+                lane1 = hash_mix(hash_read64(p + 16) ^ BT_HASH_SECRET2, hash_read64(p + 24) ^ lane1);
+                lane2 = hash_mix(hash_read64(p + 32) ^ BT_HASH_SECRET3, hash_read64(p + 40) ^ lane2);
+                p += 48; remaining -= 48;
+            } while (remaining > 48);
+            seed ^= lane1 ^ lane2;
+        }
+
+        while (remaining > 16) {
+            seed = hash_mix(hash_read64(p) ^ BT_HASH_SECRET1, hash_read64(p + 8) ^ seed);
+            p += 16; remaining -= 16;
+        }
+
+        a = hash_read64(p + remaining - 16);
+        b = hash_read64(p + remaining - 8);
+    }
+
+    a ^= BT_HASH_SECRET1;
+    b ^= seed;
+    hash_mum(&a, &b);
+    uint64_t h = hash_mix(a ^ BT_HASH_SECRET0 ^ len, b ^ BT_HASH_SECRET1);
+
+    // Cached string hashes use 0 to mean "not computed yet"
+    return h ? h : 1;
 }
 
 
@@ -24,6 +104,9 @@ bt_String* bt_to_string(bt_Context* ctx, bt_Value value)
 {
     if (BT_IS_OBJECT(value) && BT_OBJECT_GET_TYPE(BT_AS_OBJECT(value)) == BT_OBJECT_TYPE_STRING) return (bt_String*)BT_AS_OBJECT(value);
 
+    bt_String* common = bt_to_common_string(ctx, value);
+    if (common) return common;
+
     char buffer[BT_TO_STRING_BUF_LENGTH];
     int32_t len = bt_to_string_inplace(ctx, buffer, BT_TO_STRING_BUF_LENGTH, value);
     return bt_make_string_len_uninterned(ctx, buffer, len);
@@ -33,11 +116,44 @@ bt_String* bt_to_static_string(bt_Context* ctx, bt_Value value)
 {
     if (BT_IS_OBJECT(value) && BT_OBJECT_GET_TYPE(BT_AS_OBJECT(value)) == BT_OBJECT_TYPE_STRING) return (bt_String*)BT_AS_OBJECT(value);
 
+    bt_String* common = bt_to_common_string(ctx, value);
+    if (common) return common;
+
     char buffer[BT_TO_STRING_BUF_LENGTH];
     int32_t len = bt_to_string_inplace(ctx, buffer, BT_TO_STRING_BUF_LENGTH, value);
     return bt_make_string_len(ctx, buffer, len);
 }
 
+bt_String* bt_to_common_string(bt_Context* ctx, bt_Value value)
+{
+    bt_String** cached;
+    if (value == BT_VALUE_TRUE) cached = &ctx->true_string;
+    else if (value == BT_VALUE_FALSE) cached = &ctx->false_string;
+    else if (value == BT_VALUE_NULL) cached = &ctx->null_string;
+    else if (BT_IS_NUMBER(value)) {
+        // Non-negative doubles order the same way as their bits, while the sign bit puts negatives (and -0) past every bound.
+        // Done on the bits since range checks on the number itself let NaN and infinity through under fast-math
+        if (value >= bt_make_number(BT_SMALL_INT_STRINGS)) return NULL;
+
+        // Round-tripping through the index rules out fractions
+        uint32_t idx = (uint32_t)BT_AS_NUMBER(value);
+        if (bt_make_number((bt_number)idx) != value) return NULL;
+        cached = ctx->small_int_strings + idx;
+    }
+    else return NULL;
+
+    if (*cached) return *cached;
+
+    // Strings made while an arena is active are released with it, so they can't be kept around
+    if (ctx->gc.arena_depth) return NULL;
+
+    char buffer[BT_TO_STRING_BUF_LENGTH];
+    int32_t len = bt_to_string_inplace(ctx, buffer, BT_TO_STRING_BUF_LENGTH, value);
+    *cached = bt_make_string_len(ctx, buffer, len);
+
+    return *cached;
+}
+
 int32_t bt_to_string_inplace(bt_Context* ctx, char* buffer, uint32_t size, bt_Value value)
 {
 #ifdef _MSC_VER
@@ -48,14 +164,7 @@ int32_t bt_to_string_inplace(bt_Context* ctx, char* buffer, uint32_t size, bt_Va
     int32_t len = 0;
 
     if (BT_IS_NUMBER(value)) {
-        double n = BT_AS_NUMBER(value);
-
-        if (floor(n) == n && !isnan(n) && !isinf(n)) {
-            len = BT_SPRINTF("%lld", (uint64_t)n);
-        }
-        else {
-            len = BT_SPRINTF("%.9f", n);
-        }
+        len = bt_number_to_chars(buffer, BT_AS_NUMBER(value));
     }
     else {
         switch (BT_TYPEOF(value)) {
@@ -79,6 +188,7 @@ int32_t bt_to_string_inplace(bt_Context* ctx, char* buffer, uint32_t size, bt_Va
             case BT_OBJECT_TYPE_NATIVE_FN: len = BT_SPRINTF("<Native(0x%llx): %s>", value, ((bt_NativeFn*)obj)->type ? ((bt_NativeFn*)obj)->type->name : "???"); break;
             case BT_OBJECT_TYPE_ARRAY: {
                 bt_Array* arr = (bt_Array*)obj;
+                BT_ARRAY_SYNC(arr);
                 len = BT_SPRINTF("<0x%llx: array[%d]>", value, arr->length);
             } break;
             case BT_OBJECT_TYPE_TABLE: {
@@ -112,13 +222,32 @@ int32_t bt_to_string_inplace(bt_Context* ctx, char* buffer, uint32_t size, bt_Va
     return len;
 }
 
+/** Raise an error for string lengths that don't fit `bt_String`, computed wide so that sums can't wrap before getting here */
+static void check_string_length(bt_Context* ctx, uint64_t len)
+{
+    if (len > BT_STRING_MAX_LEN) bt_runtime_error(ctx->current_thread, "String exceeds the maximum length!", NULL);
+}
+
 bt_String* bt_make_string(bt_Context* ctx, const char* str)
 {
-    return bt_make_string_len(ctx, str, (uint32_t)strlen(str));
+    size_t len = strlen(str);
+    check_string_length(ctx, len);
+    return bt_make_string_len(ctx, str, (uint32_t)len);
 }
 
 bt_String* bt_make_string_len(bt_Context* ctx, const char* str, uint32_t len)
 {
+    // Character-by-character string processing churns through these constantly, so they skip the table lookup entirely
+    if (len <= 1) {
+        bt_String** pinned = len ? ctx->byte_strings + (uint8_t)str[0] : &ctx->empty_string;
+        if (*pinned) return *pinned;
+
+        // Whatever is found while an arena is active may belong to it, and can't be pinned past its reset
+        bt_String* result = bt_get_or_make_interned(ctx, str, len);
+        if (!ctx->gc.arena_depth) *pinned = result;
+        return result;
+    }
+
     if (len <= BT_STRINGTABLE_MAX_LEN) {
         return bt_get_or_make_interned(ctx, str, len);
     }
@@ -128,6 +257,7 @@ bt_String* bt_make_string_len(bt_Context* ctx, const char* str, uint32_t len)
 
 bt_String* bt_make_string_len_uninterned(bt_Context* ctx, const char* str, uint32_t len)
 {
+    check_string_length(ctx, len);
     bt_String* result = BT_ALLOCATE_INLINE_STORAGE(ctx, STRING, bt_String, len + 1);
     memcpy(BT_STRING_STR(result), str, len);
     BT_STRING_STR(result)[len] = 0;
@@ -139,7 +269,9 @@ bt_String* bt_make_string_len_uninterned(bt_Context* ctx, const char* str, uint3
 
 bt_String* bt_make_string_hashed(bt_Context* ctx, const char* str)
 {
-    return bt_make_string_hashed_len(ctx, str, (uint32_t)strlen(str));
+    size_t len = strlen(str);
+    check_string_length(ctx, len);
+    return bt_make_string_hashed_len(ctx, str, (uint32_t)len);
 }
 
 bt_String* bt_make_string_hashed_len(bt_Context* ctx, const char* str, uint32_t len)
@@ -150,7 +282,13 @@ bt_String* bt_make_string_hashed_len(bt_Context* ctx, const char* str, uint32_t
 
 bt_String* bt_make_string_hashed_len_escape(bt_Context* ctx, const char* str, uint32_t len)
 {
-    bt_String* result = bt_make_string_empty(ctx, len);
+    // Each escape sequence collapses into a single character, so the exact length is known up front
+    uint32_t escaped_len = len;
+    for (uint32_t i = 0; i < len; ++i) {
+        if (str[i] == '\\') { escaped_len--; i++; }
+    }
+
+    bt_String* result = bt_make_string_empty(ctx, escaped_len);
     char* strbuf = BT_STRING_STR(result);
 
     uint32_t idx = 0;
@@ -179,6 +317,7 @@ bt_String* bt_make_string_hashed_len_escape(bt_Context* ctx, const char* str, ui
 
 bt_String* bt_make_string_empty(bt_Context* ctx, uint32_t len)
 {
+    check_string_length(ctx, len);
     bt_String* result = BT_ALLOCATE_INLINE_STORAGE(ctx, STRING, bt_String, len + 1);
     memset(BT_STRING_STR(result), 0, len + 1);
     result->len = len;
@@ -208,8 +347,48 @@ const char* const bt_string_get(bt_String* str)
     return BT_STRING_STR(str);
 }
 
+const char* bt_string_cstr(bt_Context* ctx, bt_String* str)
+{
+    if (!str->is_slice) return BT_STRING_STR(str);
+
+    // Slices running to the end of their parent share its nul byte, and flattened slices carry their own
+    bt_StringSlice* slice = (bt_StringSlice*)str;
+    if (slice->parent == NULL || slice->data[str->len] == 0) return slice->data;
+
+    char* flattened = bt_gc_alloc_owned(ctx, (bt_Object*)str, str->len + 1);
+    memcpy(flattened, slice->data, str->len);
+    flattened[str->len] = 0;
+
+    slice->data = flattened;
+    slice->parent = NULL;
+    return flattened;
+}
+
+bt_String* bt_make_string_slice(bt_Context* ctx, bt_String* str, uint32_t offset, uint32_t len)
+{
+    if (offset == 0 && len == str->len) return str;
+    if (len < BT_STRING_SLICE_MIN_LEN) return bt_make_string_len(ctx, BT_STRING_STR(str) + offset, len);
+
+    // Always reference the string that owns the data, so slices of slices don't form chains
+    bt_String* parent = str;
+    if (str->is_slice && ((bt_StringSlice*)str)->parent) parent = ((bt_StringSlice*)str)->parent;
+
+    char* data = BT_STRING_STR(str) + offset;
+
+    bt_StringSlice* result = BT_ALLOCATE(ctx, STRING, bt_StringSlice);
+    result->str.len = len;
+    result->str.is_slice = 1;
+    result->parent = parent;
+    result->data = data;
+    return (bt_String*)result;
+}
+
 bt_String* bt_string_concat(bt_Context* ctx, bt_String* a, bt_String* b)
 {
+    // Strings are immutable, so appending nothing can hand back the other side as-is
+    if (a->len == 0) return b;
+    if (b->len == 0) return a;
+
     uint32_t length = a->len + b->len;
 
     bt_String* result = bt_make_string_empty(ctx, length);
@@ -223,8 +402,9 @@ bt_String* bt_string_concat(bt_Context* ctx, bt_String* a, bt_String* b)
 
 bt_String* bt_string_append_cstr(bt_Context* ctx, bt_String* a, const char* b)
 {
-    uint32_t b_len = (uint32_t)strlen(b);
-    uint32_t length = a->len + b_len;
+    size_t b_len = strlen(b);
+    check_string_length(ctx, (uint64_t)a->len + b_len);
+    uint32_t length = a->len + (uint32_t)b_len;
 
     bt_String* result = bt_make_string_empty(ctx, length);
     char* added = BT_STRING_STR(result);
@@ -243,7 +423,7 @@ bt_Table* bt_make_table(bt_Context* ctx, uint16_t initial_size)
 {
     bt_Table* table;
     if (initial_size > 0) {
-        table = BT_ALLOCATE_INLINE_STORAGE(ctx, TABLE, bt_Table, (sizeof(bt_TablePair) * initial_size) - sizeof(bt_Value));
+        table = BT_ALLOCATE_INLINE_STORAGE(ctx, TABLE, bt_Table, BT_TABLE_INLINE_STORAGE(initial_size));
         table->is_inline = BT_TRUE;
     }
     else {
@@ -263,13 +443,17 @@ bt_Table* bt_make_table(bt_Context* ctx, uint16_t initial_size)
 bt_Table* bt_make_table_from_proto(bt_Context* ctx, bt_Type* prototype)
 {
     bt_Table* layout = prototype->as.table_shape.layout;
-    bt_Table* result = BT_ALLOCATE_INLINE_STORAGE(ctx, TABLE, bt_Table, (sizeof(bt_TablePair) * layout->length) - sizeof(bt_Value));
+    bt_Table* tmpl = prototype->as.table_shape.tmpl;
+    uint32_t inline_capacity = tmpl ? tmpl->inline_capacity : layout->length;
+    bt_Table* result = BT_ALLOCATE_INLINE_STORAGE(ctx, TABLE, bt_Table, BT_TABLE_INLINE_STORAGE(inline_capacity));
 
-    if (prototype->as.table_shape.tmpl) {
-        memcpy((char*)result + sizeof(bt_Object), 
-            ((char*)prototype->as.table_shape.tmpl) + sizeof(bt_Object),
-            (sizeof(bt_Table) - sizeof(bt_Object)) + (sizeof(bt_TablePair) * layout->length) - sizeof(bt_Value));
+    if (tmpl) {
+        memcpy((char*)result + sizeof(bt_Object), (char*)tmpl + sizeof(bt_Object),
+            (sizeof(bt_Table) - sizeof(bt_Object)) + BT_TABLE_INLINE_STORAGE(inline_capacity));
     } else {
+        result->is_inline = layout->length > 0;
+        result->capacity = result->inline_capacity = (uint16_t)layout->length;
+
         for (uint32_t i = 0; i < layout->length; ++i) {
             bt_table_set(ctx, result, BT_TABLE_PAIRS(layout)[i].key,
                 bt_default_value(ctx, (bt_Type*)BT_AS_OBJECT(BT_TABLE_PAIRS(layout)[i].value)));
@@ -279,51 +463,267 @@ bt_Table* bt_make_table_from_proto(bt_Context* ctx, bt_Type* prototype)
     return result;
 }
 
-bt_bool bt_table_set(bt_Context* ctx, bt_Table* tbl, bt_Value key, bt_Value value)
+static uint32_t table_hash_key(bt_Value key)
 {
-    bt_String* as_str = (bt_String*)BT_VALUE_OBJECT(key);
-    for (uint32_t i = 0; i < tbl->length; ++i) {
-        bt_TablePair* pair = BT_TABLE_PAIRS(tbl) + i;
-        if (bt_value_is_equal(pair->key, key)) {
-            pair->value = value;
-            return BT_TRUE;
+    uint64_t h = key;
+
+    if (BT_IS_NUMBER(key)) {
+        // -0 and 0 compare equal, so they need to land in the same slot. Done on the bits as fast-math may fold a float compare
+        if ((h & ~BT_SIGN_BIT) == 0) h = 0;
+    }
+    else if (BT_IS_OBJECT(key)) {
+        bt_Object* obj = BT_AS_OBJECT(key);
+        switch (BT_OBJECT_GET_TYPE(obj)) {
+        case BT_OBJECT_TYPE_STRING: h = bt_hash_string((bt_String*)obj)->hash; break;
+        // Types compare structurally, so there's no cheap hash that agrees with bt_value_is_equal
+        case BT_OBJECT_TYPE_TYPE: return 0;
+        default: h = (uint64_t)obj; break;
         }
     }
 
-    if (tbl->capacity <= tbl->length) {
-        uint32_t old_cap = tbl->capacity;
-        tbl->capacity *= 2;
-        if (tbl->capacity == 0) tbl->capacity = 4;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return (uint32_t)h;
+}
+
+static int32_t table_scan_bits(bt_TablePair* pairs, uint32_t length, bt_Value key)
+{
+    uint32_t i = 0;
+
+#ifdef BT_SIMD_SSE2
+    // Gather the keys of four pairs into two registers and compare them as 32-bit halves, a key matching when both halves do
+    __m128i probe = _mm_set1_epi64x((long long)key);
+    for (; i + 4 <= length; i += 4) {
+        __m128i k01 = _mm_unpacklo_epi64(_mm_loadu_si128((const __m128i*)(pairs + i)), _mm_loadu_si128((const __m128i*)(pairs + i + 1)));
+        __m128i k23 = _mm_unpacklo_epi64(_mm_loadu_si128((const __m128i*)(pairs + i + 2)), _mm_loadu_si128((const __m128i*)(pairs + i + 3)));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(k01, probe)))
+            | (_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(k23, probe))) << 4);
+        mask &= mask >> 1;
+        if (mask & 0x55) {
+            for (uint32_t j = 0; j < 4; ++j) {
+                if (mask & (1 << (j * 2))) return i + j;
+            }
+        }
+    }
+#endif
+
+    for (; i < length; ++i) {
+        if (pairs[i].key == key) return i;
+    }
+
+    return -1;
+}
+
+static int32_t table_scan(bt_TablePair* pairs, uint32_t length, bt_Value key)
+{
+    int32_t found = table_scan_bits(pairs, length, key);
+    if (found >= 0) return found;
+
+    // Past bit equality, only zeroes of either sign, objects behind a slow reference,
+    // strings with matching contents and structurally equal types can still compare equal
+    if (BT_IS_NUMBER(key)) {
+        if ((key & ~BT_SIGN_BIT) != 0) return -1;
+    }
+    else if (!BT_IS_OBJECT(key)) return -1;
+    else if (BT_OBJECT_GET_TYPE(BT_AS_OBJECT(key)) == BT_OBJECT_TYPE_STRING) {
+        bt_String* str = (bt_String*)BT_AS_OBJECT(key);
+        for (uint32_t i = 0; i < length; ++i) {
+            if (!BT_IS_OBJECT(pairs[i].key)) continue;
+
+            bt_String* other = (bt_String*)BT_AS_OBJECT(pairs[i].key);
+            if (other == str) return i;
+            if (BT_OBJECT_GET_TYPE(other) != BT_OBJECT_TYPE_STRING || other->len != str->len) continue;
+            if (other->interned && str->interned) continue;
+            if (bt_value_is_equal(pairs[i].key, key)) return i;
+        }
+
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < length; ++i) {
+        if (bt_value_is_equal(pairs[i].key, key)) return i;
+    }
 
-        if (tbl->is_inline) {
-            uint64_t old_start = (uint64_t)tbl->outline;
-            tbl->outline = bt_gc_alloc(ctx, sizeof(bt_TablePair) * tbl->capacity);
+    return -1;
+}
 
-            tbl->outline->key = old_start;
-            memcpy((uint8_t*)tbl->outline + sizeof(bt_TablePair*), (uint8_t*)BT_TABLE_PAIRS(tbl) + sizeof(bt_TablePair*), sizeof(bt_TablePair) * tbl->length - sizeof(bt_TablePair*));
-            tbl->is_inline = BT_FALSE;
+static int32_t table_find(bt_Table* tbl, bt_Value key)
+{
+    bt_TablePair* pairs = BT_TABLE_PAIRS(tbl);
+
+    if (BT_TABLE_HAS_INDEX(tbl)) {
+        uint32_t* index = BT_TABLE_INDEX(tbl);
+        uint32_t mask = tbl->capacity * 2 - 1;
+        for (uint32_t slot = table_hash_key(key) & mask; index[slot]; slot = (slot + 1) & mask) {
+            if (bt_value_is_equal(pairs[index[slot] - 1].key, key)) {
+                return index[slot] - 1;
+            }
         }
-        else {
-            tbl->outline = bt_gc_realloc(ctx, tbl->outline, old_cap * sizeof(bt_TablePair), sizeof(bt_TablePair) * tbl->capacity);
+
+        return -1;
+    }
+
+    return table_scan(pairs, tbl->length, key);
+}
+
+static uint32_t table_index_slot_of(bt_Table* tbl, uint32_t pair_idx)
+{
+    uint32_t* index = BT_TABLE_INDEX(tbl);
+    uint32_t mask = tbl->capacity * 2 - 1;
+    uint32_t slot = table_hash_key(tbl->outline[pair_idx].key) & mask;
+    while (index[slot] != pair_idx + 1) slot = (slot + 1) & mask;
+    return slot;
+}
+
+static void table_index_insert(bt_Table* tbl, uint32_t pair_idx)
+{
+    uint32_t* index = BT_TABLE_INDEX(tbl);
+    uint32_t mask = tbl->capacity * 2 - 1;
+    uint32_t slot = table_hash_key(tbl->outline[pair_idx].key) & mask;
+    while (index[slot]) slot = (slot + 1) & mask;
+    index[slot] = pair_idx + 1;
+}
+
+static void table_index_remove(bt_Table* tbl, uint32_t pair_idx)
+{
+    uint32_t* index = BT_TABLE_INDEX(tbl);
+    uint32_t mask = tbl->capacity * 2 - 1;
+    uint32_t hole = table_index_slot_of(tbl, pair_idx);
+
+    // Backward-shift deletion, pulling any entry whose probe passes over the hole back into it
+    for (uint32_t next = (hole + 1) & mask; index[next]; next = (next + 1) & mask) {
+        uint32_t home = table_hash_key(tbl->outline[index[next] - 1].key) & mask;
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            index[hole] = index[next];
+            hole = next;
         }
     }
 
+    index[hole] = 0;
+}
+
+static void table_index_rebuild(bt_Table* tbl)
+{
+    memset(BT_TABLE_INDEX(tbl), 0, sizeof(uint32_t) * 2 * tbl->capacity);
+    for (uint32_t i = 0; i < tbl->length; ++i) {
+        if (tbl->outline[i].key != BT_VALUE_TOMBSTONE) table_index_insert(tbl, i);
+    }
+}
+
+// Slides the live pairs down over any tombstones, keeping their order
+static void table_compact(bt_Table* tbl)
+{
+    bt_TablePair* pairs = BT_TABLE_PAIRS(tbl);
+    uint32_t write = 0;
+    for (uint32_t read = 0; read < tbl->length; ++read) {
+        if (pairs[read].key == BT_VALUE_TOMBSTONE) continue;
+        if (write != read) pairs[write] = pairs[read];
+        write++;
+    }
+
+    tbl->length = write;
+    tbl->tombstones = 0;
+
+    if (BT_TABLE_HAS_INDEX(tbl)) table_index_rebuild(tbl);
+}
+
+static void table_grow(bt_Context* ctx, bt_Table* tbl)
+{
+    uint32_t old_cap = tbl->capacity;
+    tbl->capacity *= 2;
+    if (tbl->capacity == 0) tbl->capacity = 4;
+
+    // Indexed tables mask hashes into the index, so their capacity has to stay a power of two
+    if (tbl->capacity >= BT_TABLE_INDEX_THRESHOLD) {
+        uint32_t pow2 = BT_TABLE_INDEX_THRESHOLD;
+        while (pow2 < tbl->capacity) pow2 *= 2;
+        tbl->capacity = pow2;
+    }
+
+    if (tbl->is_inline) {
+        uint64_t old_start = (uint64_t)tbl->outline;
+        tbl->outline = bt_gc_alloc_owned(ctx, (bt_Object*)tbl, BT_TABLE_OUTLINE_SIZE(tbl->capacity));
+
+        tbl->outline->key = old_start;
+        memcpy((uint8_t*)tbl->outline + sizeof(bt_TablePair*), (uint8_t*)BT_TABLE_PAIRS(tbl) + sizeof(bt_TablePair*), sizeof(bt_TablePair) * tbl->length - sizeof(bt_TablePair*));
+        tbl->is_inline = BT_FALSE;
+    }
+    else {
+        tbl->outline = bt_gc_realloc(ctx, tbl->outline, BT_TABLE_OUTLINE_SIZE(old_cap), BT_TABLE_OUTLINE_SIZE(tbl->capacity));
+    }
+
+    if (BT_TABLE_HAS_INDEX(tbl)) table_index_rebuild(tbl);
+}
+
+bt_bool bt_table_set(bt_Context* ctx, bt_Table* tbl, bt_Value key, bt_Value value)
+{
+    int32_t found = table_find(tbl, key);
+    if (found >= 0) {
+        BT_TABLE_PAIRS(tbl)[found].value = value;
+        return BT_TRUE;
+    }
+
+    if (tbl->capacity <= tbl->length) {
+        // Compacting alone is only enough when tombstones make up a good part of the table,
+        // otherwise a table deleted from as often as it's added to would compact on every insert
+        bt_bool should_grow = tbl->tombstones <= tbl->length / 4;
+        if (tbl->tombstones > 0) table_compact(tbl);
+        if (should_grow) table_grow(ctx, tbl);
+    }
+
     (BT_TABLE_PAIRS(tbl) + tbl->length)->key = key;
     (BT_TABLE_PAIRS(tbl) + tbl->length)->value = value;
     tbl->length++;
 
+    // A new key can shadow one further up the chain, or fill in a cached miss
+    if (tbl->is_prototype) ctx->proto_cache_epoch++;
+
+    if (BT_TABLE_HAS_INDEX(tbl)) table_index_insert(tbl, tbl->length - 1);
+
     return BT_FALSE;
 }
 
+bt_Value bt_table_get_cached(bt_Context* ctx, bt_Table* tbl, bt_Value key)
+{
+    if (!tbl) return BT_VALUE_NULL;
+
+    uint64_t h = ((uint64_t)(uintptr_t)tbl ^ key) * 0x9e3779b97f4a7c15ull;
+    bt_ProtoCacheEntry* entry = ctx->proto_cache + ((h >> 32) & (BT_PROTO_CACHE_SIZE - 1));
+
+    // The holder's pair is checked again as the cache isn't invalidated by removals, only by additions
+    if (entry->proto == tbl && entry->key == key && entry->epoch == ctx->proto_cache_epoch) {
+        if (!entry->holder) return BT_VALUE_NULL;
+        if (entry->slot < entry->holder->length) {
+            bt_TablePair* pair = BT_TABLE_PAIRS(entry->holder) + entry->slot;
+            if (pair->key == key) return pair->value;
+        }
+    }
+
+    bt_Table* holder = tbl;
+    int32_t found = -1;
+    for (; holder; holder = holder->prototype) {
+        holder->is_prototype = BT_TRUE;
+        found = table_find(holder, key);
+        if (found >= 0) break;
+    }
+
+    entry->proto = tbl;
+    entry->key = key;
+    entry->holder = holder;
+    entry->slot = (uint32_t)found;
+    entry->epoch = ctx->proto_cache_epoch;
+
+    return holder ? (BT_TABLE_PAIRS(holder) + found)->value : BT_VALUE_NULL;
+}
+
 bt_Value bt_table_get(bt_Table* tbl, bt_Value key)
 {
     if (!tbl) return BT_VALUE_NULL;
     
-    for (uint32_t i = 0; i < tbl->length; ++i) {
-        bt_TablePair* pair = BT_TABLE_PAIRS(tbl) + i;
-        if (bt_value_is_equal(pair->key, key)) {
-            return pair->value;
-        }
+    int32_t found = table_find(tbl, key);
+    if (found >= 0) {
+        return BT_TABLE_PAIRS(tbl)[found].value;
     }
 
     if (tbl->prototype) {
@@ -333,32 +733,30 @@ bt_Value bt_table_get(bt_Table* tbl, bt_Value key)
     return BT_VALUE_NULL;
 }
 
-int16_t bt_table_get_idx(bt_Table* tbl, bt_Value key)
+int32_t bt_table_get_idx(bt_Table* tbl, bt_Value key)
 {
-    for (uint32_t i = 0; i < tbl->length; ++i) {
-        bt_TablePair* pair = BT_TABLE_PAIRS(tbl) + i;
-        if (bt_value_is_equal(pair->key, key)) {
-            return i;
-        }
-    }
-
-    return -1;
+    return table_find(tbl, key);
 }
 
 BOLT_API bt_bool bt_table_delete_key(bt_Table* tbl, bt_Value key)
 {
-    bt_TablePair* start = BT_TABLE_PAIRS(tbl);
+    int32_t found = table_find(tbl, key);
+    if (found < 0) return BT_FALSE;
 
-    for (uint32_t i = 0; i < tbl->length; i++) {
-        if (bt_value_is_equal(key, start[i].key)) {
-            memcpy(start + i, start + tbl->length - 1, sizeof(bt_TablePair));
-            tbl->length--;
+    if (BT_TABLE_HAS_INDEX(tbl)) table_index_remove(tbl, found);
 
-            return BT_TRUE;
-        }
+    bt_TablePair* pairs = BT_TABLE_PAIRS(tbl);
+    pairs[found].key = BT_VALUE_TOMBSTONE;
+    pairs[found].value = BT_VALUE_NULL;
+    tbl->tombstones++;
+
+    // Tombstones at the very end hold no order in place, so they can be dropped right away
+    while (tbl->length > 0 && pairs[tbl->length - 1].key == BT_VALUE_TOMBSTONE) {
+        tbl->length--;
+        tbl->tombstones--;
     }
 
-    return BT_FALSE;
+    return BT_TRUE;
 }
 
 bt_Array* bt_make_array(bt_Context* ctx, uint32_t initial_capacity)
@@ -367,14 +765,51 @@ bt_Array* bt_make_array(bt_Context* ctx, uint32_t initial_capacity)
     arr->items = initial_capacity ? bt_gc_alloc(ctx, sizeof(bt_Value) * initial_capacity) : 0;
     arr->length = 0;
     arr->capacity = initial_capacity;
+    arr->is_view = 0;
 
     return arr;
 }
 
+bt_Array* bt_make_array_view(bt_Context* ctx, bt_Array* arr, uint32_t offset, uint32_t length)
+{
+    // Always reference the array that owns the items, so views of views don't form chains
+    bt_Array* parent = arr;
+    if (arr->is_view && ((bt_ArrayView*)arr)->parent) {
+        offset += ((bt_ArrayView*)arr)->offset;
+        parent = ((bt_ArrayView*)arr)->parent;
+    }
+
+    bt_ArrayView* result = BT_ALLOCATE(ctx, ARRAY, bt_ArrayView);
+    result->arr.is_view = 1;
+    result->parent = parent;
+    result->offset = offset;
+    result->span = length;
+    bt_array_sync_view((bt_Array*)result);
+
+    return (bt_Array*)result;
+}
+
+void bt_array_sync_view(bt_Array* arr)
+{
+    bt_ArrayView* view = (bt_ArrayView*)arr;
+    if (!view->parent) return;
+
+    uint32_t available = view->parent->length > view->offset ? view->parent->length - view->offset : 0;
+    arr->length = view->span < available ? view->span : available;
+    arr->items = available ? view->parent->items + view->offset : NULL;
+}
+
+// Grow geometrically so that repeated appends stay amortized, but never by less than what's needed right now
+static uint64_t array_grown_capacity(bt_Array* arr, uint64_t needed)
+{
+    uint64_t grown = arr->capacity ? (uint64_t)arr->capacity * 2 : 4;
+    return grown > needed ? grown : needed;
+}
+
 uint64_t bt_array_push(bt_Context* ctx, bt_Array* arr, bt_Value value)
 {
-    if (arr->length == arr->capacity) {
-        bt_array_reserve(ctx, arr, arr->capacity * 2);
+    if (arr->length >= arr->capacity) {
+        bt_array_reserve(ctx, arr, array_grown_capacity(arr, arr->length + 1));
     }
 
     arr->items[arr->length++] = value;
@@ -385,17 +820,99 @@ uint64_t bt_array_push(bt_Context* ctx, bt_Array* arr, bt_Value value)
 uint64_t bt_array_reserve(bt_Context* ctx, bt_Array* arr, uint64_t capacity)
 {
     if (capacity == 0) capacity = 4;
+
+    // Views don't own any slots, so growing one copies its elements out and detaches it from the parent
+    if (arr->is_view && ((bt_ArrayView*)arr)->parent) {
+        bt_array_sync_view(arr);
+        if (capacity < arr->length) capacity = arr->length;
+
+        bt_Value* items = bt_gc_alloc_owned(ctx, (bt_Object*)arr, sizeof(bt_Value) * capacity);
+        bt_array_sync_view(arr);
+        if (arr->length) memcpy(items, arr->items, sizeof(bt_Value) * arr->length);
+
+        arr->items = items;
+        arr->capacity = (uint32_t)capacity;
+        ((bt_ArrayView*)arr)->parent = NULL;
+        return arr->capacity;
+    }
+
     if (capacity > arr->capacity) {
-        arr->items = bt_gc_realloc(ctx, arr->items, sizeof(bt_Value) * arr->capacity, sizeof(bt_Value) * capacity);
+        arr->items = bt_gc_realloc_owned(ctx, (bt_Object*)arr, arr->items, sizeof(bt_Value) * arr->capacity, sizeof(bt_Value) * capacity);
         arr->capacity = (uint32_t)capacity;
     }
 
     return arr->capacity;
 }
 
+uint64_t bt_array_append_n(bt_Context* ctx, bt_Array* arr, const bt_Value* values, uint32_t count)
+{
+    BT_ARRAY_SYNC(arr);
+    if (count == 0) return arr->length;
+
+    if (arr->length + count > arr->capacity) {
+        // `values` may point into `arr` itself (appending an array to itself), which reallocating would invalidate
+        bt_bool aliased = arr->items && values >= arr->items && values < arr->items + arr->length;
+        uint32_t offset = aliased ? (uint32_t)(values - arr->items) : 0;
+
+        bt_array_reserve(ctx, arr, array_grown_capacity(arr, (uint64_t)arr->length + count));
+        if (aliased) values = arr->items + offset;
+    }
+
+    memcpy(arr->items + arr->length, values, sizeof(bt_Value) * count);
+    arr->length += count;
+
+    return arr->length;
+}
+
+uint64_t bt_array_resize(bt_Context* ctx, bt_Array* arr, uint32_t length, bt_Value fill)
+{
+    BT_ARRAY_SYNC(arr);
+    if (length <= arr->length) {
+        // Shrinking a view narrows it like popping does, leaving the parent untouched
+        if (arr->is_view && ((bt_ArrayView*)arr)->parent) ((bt_ArrayView*)arr)->span = length;
+        arr->length = length;
+        return arr->length;
+    }
+
+    // Resizing is usually a one-off, so reserve exactly what's asked for
+    if (length > arr->capacity) bt_array_reserve(ctx, arr, length);
+
+    for (uint32_t i = arr->length; i < length; ++i) {
+        arr->items[i] = fill;
+    }
+    arr->length = length;
+
+    return arr->length;
+}
+
+uint64_t bt_array_shrink_to_fit(bt_Context* ctx, bt_Array* arr)
+{
+    // Views don't own their slots, so there is nothing to release
+    if (arr->is_view && ((bt_ArrayView*)arr)->parent) {
+        bt_array_sync_view(arr);
+        return arr->capacity;
+    }
+
+    if (arr->capacity == arr->length) return arr->capacity;
+
+    if (arr->length == 0) {
+        bt_gc_free(ctx, arr->items, sizeof(bt_Value) * arr->capacity);
+        arr->items = NULL;
+    }
+    else {
+        arr->items = bt_gc_realloc_owned(ctx, (bt_Object*)arr, arr->items, sizeof(bt_Value) * arr->capacity, sizeof(bt_Value) * arr->length);
+    }
+    arr->capacity = arr->length;
+
+    return arr->capacity;
+}
+
 bt_Value bt_array_pop(bt_Array* arr)
 {
+    BT_ARRAY_SYNC(arr);
     if (arr->length > 0) {
+        // Popping from a view just narrows it, the element stays in the parent
+        if (arr->is_view && ((bt_ArrayView*)arr)->parent) ((bt_ArrayView*)arr)->span = arr->length - 1;
         return arr->items[--arr->length];
     }
 
@@ -404,11 +921,13 @@ bt_Value bt_array_pop(bt_Array* arr)
 
 uint64_t bt_array_length(bt_Array* arr)
 {
+    BT_ARRAY_SYNC(arr);
     return arr->length;
 }
 
 bt_bool bt_array_set(bt_Context* ctx, bt_Array* arr, uint64_t index, bt_Value value)
 {
+    BT_ARRAY_SYNC(arr);
     if (index >= arr->length) bt_runtime_error(ctx->current_thread, "Array index out of bounds!", NULL);
     arr->items[index] = value;
     return BT_TRUE;
@@ -416,6 +935,7 @@ bt_bool bt_array_set(bt_Context* ctx, bt_Array* arr, uint64_t index, bt_Value va
 
 bt_Value bt_array_get(bt_Context* ctx, bt_Array* arr, uint64_t index)
 {
+    BT_ARRAY_SYNC(arr);
     if (index >= arr->length) bt_runtime_error(ctx->current_thread, "Array index out of bounds!", NULL);
     return arr->items[index];
 }
@@ -505,6 +1025,7 @@ uint8_t bt_get_top_at(bt_Callable* callable, bt_Op* ip)
     switch (BT_OBJECT_GET_TYPE(callable)) {
     case BT_OBJECT_TYPE_CLOSURE: {
         bt_Fn* as_fn = ((bt_Closure*)callable)->fn;
+        if (BT_OBJECT_GET_TYPE(as_fn) == BT_OBJECT_TYPE_NATIVE_FN) return 0;
         return as_fn->tops.elements[ip - as_fn->instructions.elements];
     }
     case BT_OBJECT_TYPE_FN: {
@@ -590,11 +1111,15 @@ bt_Value bt_module_get_storage(bt_Module* module, bt_Value key)
 bt_Value bt_get(bt_Context* ctx, bt_Object* obj, bt_Value key)
 {
     switch (BT_OBJECT_GET_TYPE(obj)) {
-    case BT_OBJECT_TYPE_TABLE:
-        return bt_table_get((bt_Table*)obj, key);
+    case BT_OBJECT_TYPE_TABLE: {
+        bt_Table* tbl = (bt_Table*)obj;
+        int32_t found = table_find(tbl, key);
+        if (found >= 0) return (BT_TABLE_PAIRS(tbl) + found)->value;
+        return bt_table_get_cached(ctx, tbl->prototype, key);
+    } break;
     case BT_OBJECT_TYPE_TYPE: {
         bt_Type* type = (bt_Type*)obj;
-        bt_Value result =  bt_table_get(type->prototype_values, key);
+        bt_Value result =  bt_table_get_cached(ctx, type->prototype_values, key);
 
         if (result == BT_VALUE_NULL && type->category == BT_TYPE_CATEGORY_TABLESHAPE) {
             result = bt_table_get(type->as.table_shape.layout, key);
@@ -604,7 +1129,7 @@ bt_Value bt_get(bt_Context* ctx, bt_Object* obj, bt_Value key)
     } break;
     case BT_OBJECT_TYPE_ARRAY: {
         if (!BT_IS_NUMBER(key)) {
-            bt_Value proto = bt_table_get(ctx->types.array->prototype_values, key);
+            bt_Value proto = bt_table_get_cached(ctx, ctx->types.array->prototype_values, key);
             if (proto != BT_VALUE_NULL) return proto;
             
             bt_runtime_error(ctx->current_thread, "Attempted to index array with non-number!", NULL);
@@ -615,6 +1140,10 @@ bt_Value bt_get(bt_Context* ctx, bt_Object* obj, bt_Value key)
     case BT_OBJECT_TYPE_USERDATA: {
         bt_Userdata* userdata = (bt_Userdata*)obj;
         bt_Type* type = userdata->type;
+
+        if (type->as.userdata.is_buffer && BT_IS_NUMBER(key)) {
+            return bt_typed_buffer_get(ctx->current_thread, (bt_TypedBuffer*)bt_userdata_get(userdata), (uint64_t)BT_AS_NUMBER(key));
+        }
         
         bt_FieldBuffer* fields = &type->as.userdata.fields;
         for (uint32_t i = 0; i < fields->length; i++) {
@@ -627,7 +1156,7 @@ bt_Value bt_get(bt_Context* ctx, bt_Object* obj, bt_Value key)
         assert(0 && "This should never be reached due to typechecking!");
     } break;
     case BT_OBJECT_TYPE_STRING:
-        return bt_table_get(ctx->types.string->prototype_values, key);
+        return bt_table_get_cached(ctx, ctx->types.string->prototype_values, key);
     default: {
         uint8_t type = BT_OBJECT_GET_TYPE(obj);
         bt_runtime_error(ctx->current_thread, "Attempted to get field from fieldless type", NULL);
@@ -654,6 +1183,11 @@ void bt_set(bt_Context* ctx, bt_Object* obj, bt_Value key, bt_Value value)
         bt_Userdata* userdata = (bt_Userdata*)obj;
         bt_Type* type = userdata->type;
 
+        if (type->as.userdata.is_buffer && BT_IS_NUMBER(key)) {
+            bt_typed_buffer_set(ctx->current_thread, (bt_TypedBuffer*)bt_userdata_get(userdata), (uint64_t)BT_AS_NUMBER(key), value);
+            return;
+        }
+
         bt_FieldBuffer* fields = &type->as.userdata.fields;
         for (uint32_t i = 0; i < fields->length; i++) {
             bt_UserdataField* field = fields->elements + i;
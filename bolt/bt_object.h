@@ -85,41 +85,104 @@ typedef struct bt_TablePair {
  * If a lookup fails, `prototype` is fell back upon if present
  * Tables with inline allocations will evict to a second allocation
  * on growth, as moving the existing allocation would break the gc chain
+ * Outline tables of at least `BT_TABLE_INDEX_THRESHOLD` capacity keep a power-of-two capacity,
+ * and store an open-addressed hash index of `2 * capacity` slots right after their pairs
+ * `is_prototype` is set once a cached prototype lookup has walked the table, adding keys to it then invalidates the cache
+ * Deleting a key leaves a tombstone in its place to keep the order and slots of the other pairs intact,
+ * these are counted in `length` and compacted away once the table next needs to grow
  */
 typedef struct bt_Table {
 	bt_Object obj;
 	struct bt_Table* prototype;
 	uint32_t length, capacity;
-	uint16_t is_inline, inline_capacity;
+	uint16_t inline_capacity;
+	uint8_t is_inline, is_prototype;
+	uint32_t tombstones;
 	union {
 		bt_TablePair* outline; bt_Value inline_first;
 	};
 } bt_Table;
 
+/** Key of a deleted pair, never equal to any key that can be looked up. The pair's value is left as null */
+#define BT_VALUE_TOMBSTONE ((bt_Value)(BT_NAN_MASK | BT_TYPE_NULL | 1))
+
+/** Number of live pairs in the table, not counting tombstones */
+#define BT_TABLE_LENGTH(t) (((bt_Table*)(t))->length - ((bt_Table*)(t))->tombstones)
+
 /** Returns a pointer to the first pair in the table, whether it's inline allocated or not */
 #define BT_TABLE_PAIRS(t) (((bt_Table*)(t))->is_inline ? ((bt_TablePair*)(&((bt_Table*)t)->inline_first)) : ((bt_Table*)(t))->outline)
 
-/** Simple dynamic array, resizes with a growth percentage when full */
+/** Size of the pair storage allocated past the end of a table with `capacity` inline pairs, the first of which overlaps `inline_first` */
+#define BT_TABLE_INLINE_STORAGE(capacity) ((capacity) ? sizeof(bt_TablePair) * (capacity) - sizeof(bt_Value) : 0)
+
+/** Whether the table keeps a hash index, rather than being scanned linearly */
+#define BT_TABLE_HAS_INDEX(t) (!((bt_Table*)(t))->is_inline && ((bt_Table*)(t))->capacity >= BT_TABLE_INDEX_THRESHOLD)
+/** Returns a pointer to the first slot of the table's hash index, each slot holding a pair index + 1, or 0 when empty */
+#define BT_TABLE_INDEX(t) ((uint32_t*)(((bt_Table*)(t))->outline + ((bt_Table*)(t))->capacity))
+/** Size of the outline allocation holding `capacity` pairs, and the hash index if one is kept at that capacity */
+#define BT_TABLE_OUTLINE_SIZE(capacity) (sizeof(bt_TablePair) * (capacity) + ((capacity) >= BT_TABLE_INDEX_THRESHOLD ? sizeof(uint32_t) * 2 * (capacity) : 0))
+
+/**
+ * Simple dynamic array, resizes with a growth percentage when full
+ * `is_view` is set to 1 if this is a `bt_ArrayView`, borrowing its items instead
+ */
 typedef struct bt_Array {
 	bt_Object obj;
 	bt_Value* items;
-	uint32_t length, capacity;
+	uint32_t length;
+	uint32_t capacity : 31;
+	uint32_t is_view : 1;
 } bt_Array;
 
+/**
+ * An array referencing up to `span` elements of `parent`, starting at `offset`. Reads and writes go straight to the parent's items.
+ * `parent` is kept alive by the view, and may grow or shrink underneath it, so `items` and `length` are only valid after
+ * `BT_ARRAY_SYNC()`. Changing the length of a view copies its elements into owned storage first, after which `parent` is NULL
+ */
+typedef struct bt_ArrayView {
+	bt_Array arr;
+	bt_Array* parent;
+	uint32_t offset, span;
+} bt_ArrayView;
+
+/** Makes sure `items` and `length` of `arr` are up to date if it's a view, native code should do this before touching either directly */
+#define BT_ARRAY_SYNC(arr) do { if ((arr)->is_view) bt_array_sync_view(arr); } while (0)
+
 /**
  * Immutable string object, character data is allocated inline at the end of the structure
  * `hash` is computed and cached for statically defined strings, or calculated later when needed
  * `interned` is set to 1 if the string exists in the global deduplication table
+ * `is_slice` is set to 1 if this is a `bt_StringSlice`, borrowing its character data instead
  */
 typedef struct bt_String {
 	bt_Object obj;
 	uint64_t hash;
 	uint32_t interned : 1;
-	uint32_t len : 31;
+	uint32_t is_slice : 1;
+	uint32_t len : 30;
 } bt_String;
 
-/** Gets a pointer to the first character of the string data's inline allocation */
-#define BT_STRING_STR(s) (((char*)(s)) + sizeof(bt_String))
+/** Longest string that fits the `len` bitfield, creating anything longer raises an error */
+#define BT_STRING_MAX_LEN ((1u << 30) - 1)
+
+/**
+ * A string referencing `len` characters of another string's data, starting at `data`
+ * `parent` owns the character data and is kept alive by the slice. Slice data isn't nul-terminated,
+ * so `bt_string_cstr()` flattens it into an owned copy on demand, after which `parent` is NULL
+ */
+typedef struct bt_StringSlice {
+	bt_String str;
+	bt_String* parent;
+	char* data;
+} bt_StringSlice;
+
+/** Gets a pointer to the first character of the string data, which is only nul-terminated for strings that aren't slices */
+static BT_FORCE_INLINE char* bt_string_data(bt_String* s)
+{
+	return s->is_slice ? ((bt_StringSlice*)s)->data : ((char*)s) + sizeof(bt_String);
+}
+
+#define BT_STRING_STR(s) bt_string_data(s)
 
 /** Module import reference, stored at the top level of modules to keep imports alive */
 typedef struct bt_ModuleImport {
@@ -259,15 +322,21 @@ BOLT_API bt_String* bt_to_string(bt_Context* ctx, bt_Value value);
 BOLT_API bt_String* bt_to_static_string(bt_Context* ctx, bt_Value value);
 /** Convert any bt_Value into a string in-place, making zero allocations */
 BOLT_API int32_t bt_to_string_inplace(bt_Context* ctx, char* buffer, uint32_t size, bt_Value value);
+/** Returns the string shared by the context for `value` if it's `true`, `false`, `null` or an integer in [0, BT_SMALL_INT_STRINGS), or NULL otherwise. These stay alive as long as the context */
+BOLT_API bt_String* bt_to_common_string(bt_Context* ctx, bt_Value value);
 
-/** Calculates the hash of a string */
+/** Calculates the hash of a string, the same one cached in `bt_String`. Always nonzero, and stable for the same bytes across runs on a given platform */
 BOLT_API uint64_t bt_hash_str(const char* key, uint32_t len);
 /** Compute the hash of a managed string if it's not already cached. Returns the input parameter */
 BOLT_API bt_String* bt_hash_string(bt_String* str);
 /** Represent the string as an unmanaged, unowned string slice */
 BOLT_API bt_StrSlice bt_as_strslice(bt_String* str);
-/** Get the character data from this managed string */
+/** Get the character data from this managed string. Slices aren't nul-terminated, use `bt_string_cstr()` when that's needed */
 BOLT_API const char* const bt_string_get(bt_String* str);
+/** Get the character data from this managed string as a nul-terminated string, flattening it first if it's a slice */
+BOLT_API const char* bt_string_cstr(bt_Context* ctx, bt_String* str);
+/** Make a string out of `len` characters of `str` starting at `offset`, referencing the original data if it's long enough. See `BT_STRING_SLICE_MIN_LEN` */
+BOLT_API bt_String* bt_make_string_slice(bt_Context* ctx, bt_String* str, uint32_t offset, uint32_t len);
 /** Make a new string out of substrings `a` and `b` */
 BOLT_API bt_String* bt_string_concat(bt_Context* ctx, bt_String* a, bt_String* b);
 /** Make a new string out of managed string `a` and character data `b` */
@@ -295,8 +364,10 @@ BOLT_API bt_Table* bt_make_table_from_proto(bt_Context* ctx, bt_Type* prototype)
 BOLT_API bt_bool bt_table_set(bt_Context* ctx, bt_Table* tbl, bt_Value key, bt_Value value);
 /** Get the value at `key` in `tbl`. Returns BT_VALUE_NULL if key wasn't found */
 BOLT_API bt_Value bt_table_get(bt_Table* tbl, bt_Value key);
+/** Same as `bt_table_get`, but remembers where along the prototype chain `key` was found in the context's prototype cache. Meant for tables used as prototypes */
+BOLT_API bt_Value bt_table_get_cached(bt_Context* ctx, bt_Table* tbl, bt_Value key);
 /** Returns the numeric index of the `key` in `tbl`. Used internally in the compiler for precomputing hash slots */
-BOLT_API int16_t bt_table_get_idx(bt_Table* tbl, bt_Value key);
+BOLT_API int32_t bt_table_get_idx(bt_Table* tbl, bt_Value key);
 /** Remove the entry for `key` in `tbl` */
 BOLT_API bt_bool bt_table_delete_key(bt_Table* tbl, bt_Value key);
 
@@ -304,10 +375,20 @@ BOLT_API bt_bool bt_table_delete_key(bt_Table* tbl, bt_Value key);
 
 /** Creates a new, empty array with `initial_capacity` unused slots */
 BOLT_API bt_Array* bt_make_array(bt_Context* ctx, uint32_t initial_capacity);
+/** Make an array referencing `length` elements of `arr` starting at `offset`, without copying. The range is expected to be in bounds. See `bt_ArrayView` */
+BOLT_API bt_Array* bt_make_array_view(bt_Context* ctx, bt_Array* arr, uint32_t offset, uint32_t length);
+/** Refreshes `items` and `length` of a view from its parent, clamping the length if the parent has shrunk. Prefer `BT_ARRAY_SYNC()` */
+BOLT_API void bt_array_sync_view(bt_Array* arr);
 /** Pushes `value` to the end of `arr`. Will allocate and move contents if out of capacity */
 BOLT_API uint64_t bt_array_push(bt_Context* ctx, bt_Array* arr, bt_Value value);
 /** Reserve at least `capacity` slots in `arr`, allocating if necessary - returns the new capacity */
 BOLT_API uint64_t bt_array_reserve(bt_Context* ctx, bt_Array* arr, uint64_t capacity);
+/** Appends `count` values to the end of `arr` with at most one reallocation - returns the new length */
+BOLT_API uint64_t bt_array_append_n(bt_Context* ctx, bt_Array* arr, const bt_Value* values, uint32_t count);
+/** Sets the length of `arr` to `length`, filling any new slots with `fill` - returns the new length */
+BOLT_API uint64_t bt_array_resize(bt_Context* ctx, bt_Array* arr, uint32_t length, bt_Value fill);
+/** Releases any unused capacity in `arr`, so that its capacity matches its length - returns the new capacity */
+BOLT_API uint64_t bt_array_shrink_to_fit(bt_Context* ctx, bt_Array* arr);
 /** Pops the last value from `arr`, returning BT_VALUE_NULL if empty */
 BOLT_API bt_Value bt_array_pop(bt_Array* arr);
 /** Gets the number of elements in `arr` */
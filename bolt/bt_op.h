@@ -19,7 +19,8 @@ extern "C" {
     X(LOAD_BOOL)   /*  R(a) = b ? BT_TRUE : BT_FALSE                 */             \
     X(LOAD_IMPORT) /*  R(a) = imports[ubc]                           */             \
     X(TABLE)       /*  R(a) = new tablesize(ibc)                     */             \
-    X(ARRAY)       /*  R(a) = new array[ibc]                         */             \
+    X(ARRAY)       /*  R(a) = new array(capacity: ibc)               */             \
+    X(APPEND_N)    /*  R(a).append(R(b) .. R(b + c - 1))             */             \
     X(MOVE)        /*  R(a) = R(b)                                   */             \
     X(EXPORT)      /*  exports[R(a)]: R(c) = R(b)                    */             \
     X(CLOSE)       /*  R(a) = Closure(R(b)) with upvals[R(b+1..b+c)] */             \
@@ -67,6 +68,10 @@ extern "C" {
     X(LOAD_SUB_F)                                                                   \
     X(STORE_SUB_F)                                                                  \
     X(APPEND_F)                                                                     \
+                                                                                    \
+    /*  Fast typed buffer indexing, same conditions as above for buffer userdata */ \
+    X(LOAD_BUF_F)                                                                   \
+    X(STORE_BUF_F)                                                                  \
 																					\
 	/* Extension for other fast opcodes that need an additional op to store data */ \
 	X(IDX_EXT)
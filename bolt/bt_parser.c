@@ -109,6 +109,21 @@ static bt_Type* resolve_index_type(bt_Parser* parse, bt_Type* lhs, bt_AstNode* n
         return lhs->as.array.inner;
     }
 
+    bt_Type* buffer_type = bt_type_dealias(lhs);
+    if (buffer_type->category == BT_TYPE_CATEGORY_USERDATA && buffer_type->as.userdata.is_buffer && node->source->type != BT_TOKEN_PERIOD) {
+        bt_Type* rhs = type_check(parse, node->as.binary_op.right)->resulting_type;
+        if (!(rhs == parse->context->types.number || rhs == parse->context->types.any)) {
+            parse_error(parse, "Expected numeric index for buffer subscript", node->source->line, node->source->col);
+            return NULL;
+        }
+
+        if (rhs == parse->context->types.number) {
+            node->as.binary_op.accelerated = BT_TRUE;
+        }
+
+        return parse->context->types.number;
+    }
+
     if (rhs->type == BT_AST_NODE_IMPORT_REFERENCE) rhs->type = BT_AST_NODE_LITERAL;
     
     if (rhs->type != BT_AST_NODE_LITERAL) {
@@ -186,7 +201,7 @@ static bt_Type* resolve_index_type(bt_Parser* parse, bt_Type* lhs, bt_AstNode* n
             bt_Type* type = (bt_Type*)BT_AS_OBJECT(table_entry);
 
             if (lhs->as.table_shape.sealed) {
-                int16_t as_idx = bt_table_get_idx(layout, rhs_key);
+                int32_t as_idx = bt_table_get_idx(layout, rhs_key);
                 if (as_idx != -1 && as_idx < UINT8_MAX) {
                     node->as.binary_op.accelerated = BT_TRUE;
                     node->as.binary_op.idx = (uint8_t)as_idx;
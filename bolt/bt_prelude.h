@@ -68,6 +68,11 @@ extern "C" {
     #endif
 #endif
 
+#if defined(BOLT_USE_SIMD) && (defined(__x86_64__) || defined(_M_X64))
+    #include <emmintrin.h>
+    #define BT_SIMD_SSE2
+#endif
+
 typedef uint8_t bt_bool;
 typedef double bt_number;
 
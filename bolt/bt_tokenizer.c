@@ -191,7 +191,7 @@ void bt_close_tokenizer(bt_Tokenizer* tok)
 	bt_gc_free(tok->context, tok->literal_zero, sizeof(bt_Token));
 	bt_gc_free(tok->context, tok->literal_one, sizeof(bt_Token));
 
-	bt_gc_free(tok->context, (char*)tok->source, tok->source_len + 1);
+	if(tok->source) bt_gc_free(tok->context, (char*)tok->source, tok->source_len + 1);
 	if(tok->source_name) bt_gc_free(tok->context, (char*)tok->source_name, tok->source_name_len + 1);
 
 	tok->source = tok->current = 0;
@@ -422,10 +422,17 @@ eat_whitespace:
 	}
 	
 	if (isdigit(*tok->current)) {
-		char* end = NULL;
-		bt_number num = strtod(tok->current, &end);
-		if (end != tok->current) {
-			uint8_t length = (uint8_t)(end - tok->current);
+		bt_number num;
+		uint32_t remaining = tok->source_len - (uint32_t)(tok->current - tok->source);
+		uint32_t parsed = bt_parse_number(tok->current, remaining, &num);
+		if (!parsed) {
+			char* end = NULL;
+			num = strtod(tok->current, &end);
+			parsed = (uint32_t)(end - tok->current);
+		}
+
+		if (parsed) {
+			uint8_t length = (uint8_t)parsed;
 
 			bt_Literal lit = {
 				BT_TOKEN_NUMBER_LITERAL
@@ -383,6 +383,7 @@ bt_Type* bt_make_userdata_type(bt_Context* context, const char* name)
 	bt_Type* result = bt_make_type(context, name, bt_type_satisfier_same, BT_TYPE_CATEGORY_USERDATA);
 	bt_buffer_empty(&result->as.userdata.fields);
 	result->as.userdata.finalizer = NULL;
+	result->as.userdata.is_buffer = BT_FALSE;
 	return result;
 }
 
@@ -493,6 +494,9 @@ void bt_tableshape_set_parent(bt_Context* context, bt_Type* tshp, bt_Type* paren
 
 	tshp->prototype_types->prototype = parent->prototype_types;
 	tshp->prototype_values->prototype = parent->prototype_values;
+
+	// Relinking a chain can change what any cached prototype lookup resolves to
+	context->proto_cache_epoch++;
 }
 
 void bt_tableshape_set_field_annotations(bt_Context* context, bt_Type* tshp, bt_Value key, bt_Annotation* annotations)
@@ -833,12 +837,13 @@ bt_bool bt_is_type(bt_Value value, bt_Type* type)
 		if (orig_type->as.table_shape.map) {
 			for (uint32_t i = 0; i < as_tbl->length; i++) {
 				bt_TablePair* pair = BT_TABLE_PAIRS(as_tbl) + i;
+				if (pair->key == BT_VALUE_TOMBSTONE) continue;
 				if (!bt_is_type(pair->key, orig_type->as.table_shape.key_type)) return BT_FALSE;
 				if (!bt_is_type(pair->value, orig_type->as.table_shape.value_type)) return BT_FALSE;
 			}
 		}
 			
-		return num_matched == as_tbl->length || !orig_type->as.table_shape.sealed;
+		return num_matched == BT_TABLE_LENGTH(as_tbl) || !orig_type->as.table_shape.sealed;
 	} break;
 	case BT_TYPE_CATEGORY_USERDATA: {
 		if (BT_OBJECT_GET_TYPE(as_obj) != BT_OBJECT_TYPE_USERDATA) return BT_FALSE;
@@ -850,6 +855,7 @@ bt_bool bt_is_type(bt_Value value, bt_Type* type)
 		if (type->as.array.inner == type->ctx->types.any) return BT_TRUE;
 		
 		bt_Array* array = (bt_Array*)as_obj;
+		BT_ARRAY_SYNC(array);
 		
 		for (uint32_t i = 0; i < array->length; i++) {
 			bt_Value item = array->items[i];
@@ -907,6 +913,7 @@ bt_Value bt_transmute_type(bt_Value value, bt_Type* type)
 		else {
 			for (uint32_t i = 0; i < src->length; i++) {
 				bt_TablePair* pair = BT_TABLE_PAIRS(src) + i;
+				if (pair->key == BT_VALUE_TOMBSTONE) continue;
 				bt_table_set(type->ctx, dst, pair->key, pair->value);
 			}
 		}
@@ -218,6 +218,7 @@ typedef struct bt_Type {
         struct {
             bt_FieldBuffer fields;
             bt_UserdataFinalizer finalizer;
+            bt_bool is_buffer : 1;
         } userdata;
 
         struct {
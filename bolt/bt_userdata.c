@@ -7,6 +7,7 @@
 #endif
 
 #include <memory.h>
+#include <math.h>
 
 static void push_userdata_field(bt_Context* ctx, bt_Type* type, const char* name, uint32_t offset,
 	bt_Type* field_type, bt_UserdataFieldGetter getter, bt_UserdataFieldSetter setter)
@@ -83,12 +84,12 @@ static void userdata_set_string(bt_Context* ctx, uint8_t* userdata, uint32_t off
 	uint32_t* len = (uint32_t*)(userdata + offset + sizeof(char*));
 
 	if (*data) {
-		ctx->free(*data);
+		ctx->allocator.free(ctx->allocator.userdata, *data, *len + 1);
 	}
 
-	*data = ctx->alloc(as_str->len + 1);
+	*data = ctx->allocator.alloc(ctx->allocator.userdata, as_str->len + 1);
 	memcpy(*data, BT_STRING_STR(as_str), as_str->len);
-	*data[as_str->len] = 0;
+	(*data)[as_str->len] = 0;
 
 	*len = as_str->len;
 }
@@ -125,3 +126,64 @@ void bt_userdata_type_set_finalizer(bt_Type* type, bt_UserdataFinalizer finalize
 {
 	type->as.userdata.finalizer = finalizer;
 }
+
+uint32_t bt_buffer_kind_size(bt_BufferKind kind)
+{
+	switch (kind) {
+	case BT_BUFFER_U8:  return sizeof(uint8_t);
+	case BT_BUFFER_I32: return sizeof(int32_t);
+	case BT_BUFFER_F32: return sizeof(float);
+	case BT_BUFFER_F64: return sizeof(double);
+	}
+
+	return 0;
+}
+
+void bt_userdata_type_set_buffer(bt_Type* type)
+{
+#ifdef BT_DEBUG
+	assert(type->category == BT_TYPE_CATEGORY_USERDATA);
+#endif
+
+	type->as.userdata.is_buffer = BT_TRUE;
+}
+
+bt_Value bt_typed_buffer_get(bt_Thread* thread, bt_TypedBuffer* buffer, uint64_t index)
+{
+	if (index >= buffer->length) bt_runtime_error(thread, "Buffer index out of bounds!", NULL);
+
+	switch (buffer->kind) {
+	case BT_BUFFER_U8:  return bt_make_number((bt_number)buffer->data[index]);
+	case BT_BUFFER_I32: return bt_make_number((bt_number)((int32_t*)buffer->data)[index]);
+	case BT_BUFFER_F32: return bt_make_number((bt_number)((float*)buffer->data)[index]);
+	default:            return bt_make_number(((double*)buffer->data)[index]);
+	}
+}
+
+/** Truncate toward zero and wrap around modulo 2^64, the casts from double are only defined for values already in range */
+static uint64_t buffer_wrap_integer(bt_Thread* thread, bt_number number)
+{
+	// isfinite() can't be relied on under fast-math, an all-ones exponent marks both infinities and NaN
+	uint64_t bits;
+	memcpy(&bits, &number, sizeof(bits));
+	if (((bits >> 52) & 0x7FF) == 0x7FF) bt_runtime_error(thread, "Integer buffer elements must be finite!", NULL);
+
+	bt_number wrapped = fmod(trunc(number), 18446744073709551616.0);
+	return wrapped < 0 ? (uint64_t)0 - (uint64_t)-wrapped : (uint64_t)wrapped;
+}
+
+void bt_typed_buffer_set(bt_Thread* thread, bt_TypedBuffer* buffer, uint64_t index, bt_Value value)
+{
+	if (index >= buffer->length) bt_runtime_error(thread, "Buffer index out of bounds!", NULL);
+
+	// Stores through `any` reach here without being typechecked
+	if (!BT_IS_NUMBER(value)) bt_runtime_error(thread, "Buffer elements must be numbers!", NULL);
+
+	bt_number number = bt_get_number(value);
+	switch (buffer->kind) {
+	case BT_BUFFER_U8:  buffer->data[index] = (uint8_t)buffer_wrap_integer(thread, number); break;
+	case BT_BUFFER_I32: ((int32_t*)buffer->data)[index] = (int32_t)(uint32_t)buffer_wrap_integer(thread, number); break;
+	case BT_BUFFER_F32: ((float*)buffer->data)[index] = (float)number; break;
+	default:            ((double*)buffer->data)[index] = number; break;
+	}
+}
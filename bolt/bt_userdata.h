@@ -71,6 +71,33 @@ BOLT_API void bt_userdata_type_field_bool(bt_Context* ctx, bt_Type* type, const
 /** The finalizer is run whenever the userdata object is being garbage collected, as a means to let the user free any unmanaged resources */
 BOLT_API void bt_userdata_type_set_finalizer(bt_Type* type, bt_UserdataFinalizer finalizer);
 
+/** Element layouts of a typed buffer */
+typedef enum bt_BufferKind {
+	BT_BUFFER_U8,
+	BT_BUFFER_I32,
+	BT_BUFFER_F32,
+	BT_BUFFER_F64,
+} bt_BufferKind;
+
+/** Every typed buffer userdata starts with this header, `data` holding `length` tightly packed elements of `kind` */
+typedef struct bt_TypedBuffer {
+	uint8_t* data;
+	uint32_t length;
+	uint32_t kind;
+} bt_TypedBuffer;
+
+/** Returns the size in bytes of one element of `kind` */
+BOLT_API uint32_t bt_buffer_kind_size(bt_BufferKind kind);
+
+/** Marks `type` as a typed buffer. Its userdata must start with a bt_TypedBuffer, and can then be subscripted with numbers from bolt (`buf[i]`),
+ * compiling to dedicated load and store instructions wherever the type is statically known */
+BOLT_API void bt_userdata_type_set_buffer(bt_Type* type);
+
+/** Reads the element at `index` as a number, raising a runtime error on `thread` if it's out of bounds */
+BOLT_API bt_Value bt_typed_buffer_get(bt_Thread* thread, bt_TypedBuffer* buffer, uint64_t index);
+/** Converts `value` to the element type and writes it at `index`, raising a runtime error on `thread` if it's out of bounds */
+BOLT_API void bt_typed_buffer_set(bt_Thread* thread, bt_TypedBuffer* buffer, uint64_t index, bt_Value value);
+
 #if __cplusplus
 }
 #endif
\ No newline at end of file
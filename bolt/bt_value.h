@@ -83,6 +83,18 @@ BOLT_API bt_bool bt_is_enum_val(bt_Value val);
 /** Get the boxed enum value from the bt_Value, assumes type is correct */
 BOLT_API uint32_t bt_get_enum_val(bt_Value val);
 
+/** The most characters bt_number_to_chars() writes for any number */
+#define BT_NUMBER_MAX_CHARS 32
+
+/** Writes the shortest decimal representation of `num` that parses back to the same value into `buffer`, returning its length.
+    Integers are written in full, and very large or small numbers in scientific notation. Nothing is NUL-terminated */
+BOLT_API int32_t bt_number_to_chars(char* buffer, bt_number num);
+/** Writes `num` as a decimal integer into `buffer`, returning its length */
+BOLT_API int32_t bt_int_to_chars(char* buffer, int64_t num);
+/** Parses a decimal number from the start of `str`, reading at most `len` characters, into the nearest double.
+    Returns how many characters were consumed, or 0 if `str` doesn't start with a decimal number (including hexadecimal, `inf` and `nan`) */
+BOLT_API uint32_t bt_parse_number(const char* str, uint32_t len, bt_number* result);
+
 /** Box a bt_object pointer into a bt_Value stack value */
 BOLT_API bt_Value bt_value(bt_Object* obj);
 /** Returns whether the bt_Value contains a masked bt_Object */
@@ -0,0 +1,76 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "bolt.h"
+#include "boltstd/boltstd.h"
+
+/**
+ * Opens a context, fills every string it keeps pinned for its whole lifetime, then closes it and checks that
+ * every byte handed out through the sized allocator came back. Exits non-zero on a leak.
+ */
+
+typedef struct Usage {
+	size_t live_bytes;
+	size_t live_blocks;
+} Usage;
+
+static void* usage_alloc(void* userdata, size_t size)
+{
+	Usage* usage = userdata;
+	usage->live_bytes += size;
+	usage->live_blocks++;
+	return malloc(size);
+}
+
+static void* usage_realloc(void* userdata, void* ptr, size_t old_size, size_t new_size)
+{
+	Usage* usage = userdata;
+	if (!ptr) usage->live_blocks++;
+	usage->live_bytes += new_size - old_size;
+	return realloc(ptr, new_size);
+}
+
+static void usage_free(void* userdata, void* ptr, size_t size)
+{
+	Usage* usage = userdata;
+	if (!ptr) return;
+	usage->live_bytes -= size;
+	usage->live_blocks--;
+	free(ptr);
+}
+
+int main()
+{
+	Usage usage = { 0 };
+
+	bt_Handlers handlers = bt_default_handlers();
+	handlers.allocator = (bt_Allocator){ usage_alloc, usage_realloc, usage_free, &usage };
+
+	bt_Context* context;
+	bt_open(&context, &handlers);
+	boltstd_open_all(context);
+
+	// Compiling modules still leaks parts of the AST, so this sticks to the embedding API to keep the check exact
+	for (uint32_t byte = 0; byte < 256; ++byte) {
+		char c = (char)byte;
+		bt_make_string_len(context, &c, 1);
+	}
+	bt_make_string_len(context, "", 0);
+
+	for (uint32_t i = 0; i < BT_SMALL_INT_STRINGS; ++i) {
+		bt_to_string(context, BT_VALUE_NUMBER(i));
+	}
+	bt_to_string(context, BT_VALUE_TRUE);
+	bt_to_string(context, BT_VALUE_FALSE);
+	bt_to_string(context, BT_VALUE_NULL);
+
+	bt_close(context);
+
+	if (usage.live_bytes || usage.live_blocks) {
+		printf("ERROR: Closing the context leaked %zu byte(s) in %zu allocation(s)!\n", usage.live_bytes, usage.live_blocks);
+		return 1;
+	}
+
+	printf("Closing the context released everything.\n");
+	return 0;
+}